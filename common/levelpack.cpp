@@ -0,0 +1,224 @@
+#include "levelpack.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char PACK_MAGIC[4] = {'V', 'L', 'P', 'K'};
+static const uint32_t PACK_VERSION = 1;
+static const size_t HEADER_SIZE = 16;
+static const size_t ENTRY_SIZE = 32;
+static const size_t NAME_SIZE = 20;
+
+static uint32_t read32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read16(const unsigned char* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static void put32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out += (char)((v >> (i * 8)) & 0xff);
+}
+
+static void put16(std::string& out, uint16_t v) {
+    out += (char)(v & 0xff);
+    out += (char)(v >> 8);
+}
+
+static bool readFile(const std::string& path, std::string& text) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in.is_open()) return false;
+    std::stringstream ss;
+    ss << in.rdbuf();
+    text = ss.str();
+    return true;
+}
+
+// Longest line and line count of a map text
+static void measure(const std::string& text, int& width, int& height) {
+    width = height = 0;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        width = std::max(width, (int)(end - start));
+        height++;
+        start = end + 1;
+    }
+}
+
+static std::string baseName(const std::string& path) {
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".txt") == 0) {
+        name.resize(name.size() - 4);
+    }
+    return name;
+}
+
+LevelPack::LevelPack() : data(nullptr), size(0), levels(0) {}
+
+LevelPack::~LevelPack() {
+    close();
+}
+
+void LevelPack::close() {
+    if (data) munmap((void*)data, size);
+    data = nullptr;
+    size = 0;
+    levels = 0;
+    files.clear();
+}
+
+bool LevelPack::load(const std::string& mapsDir) {
+    close();
+    if (openPack(mapsDir + ".pack")) return true;
+
+    // No pack: levels are map0.txt, map1.txt, ... up to the first gap
+    while (true) {
+        std::stringstream ss;
+        ss << mapsDir << "/map" << files.size() << ".txt";
+        if (access(ss.str().c_str(), R_OK) != 0) break;
+        files.push_back(ss.str());
+    }
+    levels = files.size();
+    return levels > 0;
+}
+
+bool LevelPack::openPack(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= HEADER_SIZE) {
+        map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    data = (const unsigned char*)map;
+    size = st.st_size;
+
+    // Check the header and that every record lies inside the file
+    uint32_t count = read32(data + 8);
+    uint32_t table = read32(data + 12);
+    bool valid = memcmp(data, PACK_MAGIC, 4) == 0 && read32(data + 4) == PACK_VERSION &&
+                 table <= size && count <= (size - table) / ENTRY_SIZE;
+    for (uint32_t i = 0; valid && i < count; ++i) {
+        const unsigned char* entry = data + table + i * ENTRY_SIZE;
+        uint32_t offset = read32(entry), length = read32(entry + 4);
+        valid = offset <= size && length <= size - offset;
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    levels = count;
+    return true;
+}
+
+int LevelPack::count() const {
+    return levels;
+}
+
+std::string LevelPack::name(int index) const {
+    if (index < 0 || index >= levels) return "";
+    if (!data) return baseName(files[index]);
+
+    const char* name = (const char*)data + read32(data + 12) + index * ENTRY_SIZE + 12;
+    return std::string(name, strnlen(name, NAME_SIZE));
+}
+
+int LevelPack::width(int index) const {
+    if (index < 0 || index >= levels) return 0;
+    if (data) return read16(data + read32(data + 12) + index * ENTRY_SIZE + 8);
+
+    int width, height;
+    measure(text(index), width, height);
+    return width;
+}
+
+int LevelPack::height(int index) const {
+    if (index < 0 || index >= levels) return 0;
+    if (data) return read16(data + read32(data + 12) + index * ENTRY_SIZE + 10);
+
+    int width, height;
+    measure(text(index), width, height);
+    return height;
+}
+
+std::string LevelPack::text(int index) const {
+    if (index < 0 || index >= levels) return "";
+    if (!data) {
+        std::string text;
+        readFile(files[index], text);
+        return text;
+    }
+
+    const unsigned char* entry = data + read32(data + 12) + index * ENTRY_SIZE;
+    return std::string((const char*)data + read32(entry), read32(entry + 4));
+}
+
+bool writeLevelPack(const std::string& path, std::vector<std::string> files) {
+    std::sort(files.begin(), files.end(), [](const std::string& a, const std::string& b) {
+        return naturalLess(baseName(a), baseName(b));
+    });
+
+    std::string table, records;
+    size_t recordsStart = HEADER_SIZE + files.size() * ENTRY_SIZE;
+    for (const auto& file : files) {
+        std::string text;
+        if (!readFile(file, text)) return false;
+
+        int width, height;
+        measure(text, width, height);
+        std::string name = baseName(file).substr(0, NAME_SIZE - 1);
+
+        put32(table, recordsStart + records.size());
+        put32(table, text.size());
+        put16(table, std::min(width, 0xffff));
+        put16(table, std::min(height, 0xffff));
+        table += name;
+        table.append(NAME_SIZE - name.size(), '\0');
+        records += text;
+    }
+
+    std::string header(PACK_MAGIC, 4);
+    put32(header, PACK_VERSION);
+    put32(header, files.size());
+    put32(header, HEADER_SIZE);
+
+    std::ofstream out(path.c_str(), std::ios::binary);
+    if (!out.is_open()) return false;
+    out << header << table << records;
+    return out.good();
+}
+
+bool naturalLess(const std::string& a, const std::string& b) {
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (isdigit((unsigned char)a[i]) && isdigit((unsigned char)b[j])) {
+            size_t ei = i, ej = j;
+            while (ei < a.size() && isdigit((unsigned char)a[ei])) ei++;
+            while (ej < b.size() && isdigit((unsigned char)b[ej])) ej++;
+            std::string na = a.substr(i, ei - i), nb = b.substr(j, ej - j);
+            if (na.size() != nb.size()) return na.size() < nb.size();
+            if (na != nb) return na < nb;
+            i = ei;
+            j = ej;
+        } else {
+            if (a[i] != b[j]) return a[i] < b[j];
+            i++;
+            j++;
+        }
+    }
+    return a.size() - i < b.size() - j;
+}
@@ -0,0 +1,56 @@
+#ifndef LEVELPACK_H
+#define LEVELPACK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Levels of a game, read from a single pack file when there is one and
+// from one text file per level (map0.txt, map1.txt, ...) otherwise.
+//
+// Pack layout, all integers little-endian:
+//   header   "VLPK", u32 version, u32 level count, u32 table offset
+//   table    per level: u32 record offset, u32 record size,
+//            u16 width, u16 height, char name[20] (NUL padded)
+//   records  the level's map text, exactly as in its .txt file
+// Width and height are the text's longest line and its line count.
+//
+// The pack is memory-mapped, so opening it costs the same for ten levels
+// or ten thousand and a level's text is only read when it is played.
+class LevelPack {
+public:
+    LevelPack();
+    ~LevelPack();
+
+    // Open <mapsDir>.pack, or count <mapsDir>/map<N>.txt from 0 up when
+    // there is no pack. False if neither has any level.
+    bool load(const std::string& mapsDir);
+
+    int count() const;
+    std::string name(int index) const;
+    int width(int index) const;
+    int height(int index) const;
+
+    // Map text of a level; empty if the index is out of range
+    std::string text(int index) const;
+
+private:
+    LevelPack(const LevelPack&);
+    LevelPack& operator=(const LevelPack&);
+
+    bool openPack(const std::string& path);
+    void close();
+
+    const unsigned char* data;
+    size_t size;
+    int levels;
+    std::vector<std::string> files; // Text files when there is no pack
+};
+
+// Build a pack from level files, in natural order of their names
+bool writeLevelPack(const std::string& path, std::vector<std::string> files);
+
+// Orders "map2.txt" before "map10.txt"
+bool naturalLess(const std::string& a, const std::string& b);
+
+#endif // LEVELPACK_H
@@ -0,0 +1,19 @@
+// Builds a level pack (see levelpack.h) from map text files.
+// Usage: mkpack <out.pack> <map files...>
+
+#include "levelpack.h"
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <out.pack> <map files...>" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files(argv + 2, argv + argc);
+    if (!writeLevelPack(argv[1], files)) {
+        std::cerr << "Failed to write " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
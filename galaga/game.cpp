@@ -1,6 +1,14 @@
 #include "game.h"
 #include "globals.h"
 #include "renderer.h"
+#include "grid.h"
+#include "pool.h"
+#include "waves.h"
+#include "paths.h"
+#include "particles.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -8,114 +16,299 @@
 #include <thread>
 #include <sstream>
 
-struct Bullet
-{
-    int x, y;
-    bool active;
-};
+// Most bullets and enemies on screen at once; shots and spawns past these
+// are dropped
+const int MAX_BULLETS = 64;
+const int MAX_ENEMIES = 256;
+// Rows a bullet climbs per tick; collisions are swept, so any speed is safe
+const int BULLET_SPEED = 1;
+// Length of a tick, whatever the input does
+const int TICK_MS = 100;
+// Most cells the ship moves per tick, however many keys were queued
+const int SHIP_SPEED = 2;
+// Ticks between shots: one a tick, the rate the game always had
+const int FIRE_COOLDOWN = 1;
+
+Pool bullets;
+Pool enemies;
+Particles particles;
+Grid enemy_grid; // Live enemies by the cells they crossed, rebuilt by check_collisions()
+int player_from_x = 0, player_from_y = 0; // Where the ship began the tick
+int fire_cooldown = 0;                     // Ticks until the ship can fire again
+bool game_running = true; // For outer loop
 
-struct Enemy
+enum EnemyMode
 {
-    int x, y;
-    bool active;
+    MODE_ENTERING,  // Flying in to its slot
+    MODE_FORMATION, // In its slot, moving with the formation
+    MODE_DIVING,    // Out of its slot on a dive path, back in at the end
 };
 
-std::vector<Bullet> bullets;
-std::vector<Enemy> enemies;
-int tick_counter = 0;
-bool game_running = true; // For outer loop
+// Per enemy, by pool id, alongside the pool's coordinates
+std::vector<int> slot_x, slot_y; // Slot in the formation before it came down
+std::vector<int> enemy_mode;
+std::vector<int> enemy_path; // Path flown, or -1
+std::vector<int> path_step;  // Index into the path's table
+
+// The wave script being played
+Campaign campaign;
+WaveRun run = {0, 0, 0};
+int enemy_speed = 5;  // Ticks between formation steps
+int step_timer = 0;   // Ticks since the last one
+int formation_dy = 0; // Rows the formation has come down this wave
 
 void reset_game()
 {
-    enemies.clear();
-    bullets.clear();
+    if (pool_capacity(bullets) == 0) pool_init(bullets, MAX_BULLETS);
+    if (pool_capacity(enemies) == 0) pool_init(enemies, MAX_ENEMIES);
+    slot_x.assign(MAX_ENEMIES, 0);
+    slot_y.assign(MAX_ENEMIES, 0);
+    enemy_mode.assign(MAX_ENEMIES, MODE_FORMATION);
+    enemy_path.assign(MAX_ENEMIES, -1);
+    path_step.assign(MAX_ENEMIES, 0);
+    pool_clear(enemies);
+    pool_clear(bullets);
+    if (particles.life.empty()) particles_init(particles);
+    particles_clear(particles);
     GAME_OVER = false;
     SCORE = 0;
     LIVES = 3;
     PLAYER_X = GAME_WIDTH / 2;
     PLAYER_Y = GAME_HEIGHT - 1;
-    tick_counter = 0;
+    fire_cooldown = 0;
+}
+
+// Each wave's formation starts in its slots at the default speed
+void reset_formation()
+{
+    enemy_speed = 5;
+    step_timer = 0;
+    formation_dy = 0;
 }
 
-void spawn_enemies()
+void spawn_enemy(int x, int y, int entry)
 {
-    // Simple formation
-    for (int i = 0; i < 6; ++i)
+    // Slots are on the field and the formation holds still until the wave
+    // has spawned, but keep a late enemy off the ship's row regardless
+    int path = entry >= ENTRY_PATH ? entry - ENTRY_PATH : -1;
+    int start_x = x, start_y = entry == ENTRY_TOP ? 1 : std::min(y + formation_dy, GAME_HEIGHT - 2);
+    if (path >= 0)
     {
-        for (int j = 0; j < 3; ++j)
+        start_x += fixed_to_cell(path_table(path).dx[0]);
+        start_y += fixed_to_cell(path_table(path).dy[0]);
+    }
+
+    int id = pool_spawn(enemies, start_x, start_y);
+    if (id < 0) return;
+    slot_x[id] = x;
+    slot_y[id] = y;
+    enemy_mode[id] = entry == ENTRY_NONE ? MODE_FORMATION : MODE_ENTERING;
+    enemy_path[id] = path;
+    path_step[id] = 0;
+}
+
+// Send the enemy in formation nearest the ship's column (the lowest of
+// those) down a dive path
+void start_dive(int path)
+{
+    int best = -1;
+    for (int i = 0; i < enemies.count; ++i)
+    {
+        int id = enemies.live[i];
+        if (enemy_mode[id] != MODE_FORMATION) continue;
+        int dist = std::abs(enemies.x[id] - PLAYER_X);
+        int best_dist = best < 0 ? 0 : std::abs(enemies.x[best] - PLAYER_X);
+        if (best < 0 || dist < best_dist || (dist == best_dist && enemies.y[id] > enemies.y[best]))
         {
-            // Center the enemies: Width 40. 6*4=24. Margin (40-24)/2 = 8.
-            enemies.push_back({8 + i * 4, 2 + j * 2, true});
+            best = id;
         }
     }
+    if (best < 0) return;
+
+    enemy_mode[best] = MODE_DIVING;
+    enemy_path[best] = path;
+    path_step[best] = 0;
+}
+
+// Move on to the next wave once this one has nothing left to spawn and
+// nothing left alive, then apply the events that are due
+void run_wave()
+{
+    if (wave_begin_tick(campaign, run, enemies.count)) reset_formation();
+
+    while (const WaveEvent* e = wave_next_event(campaign, run))
+    {
+        if (e->op == WAVE_SPAWN) spawn_enemy(e->a, e->b, e->c);
+        else if (e->op == WAVE_SPEED) enemy_speed = e->a;
+        else if (e->op == WAVE_DIVE) start_dive(e->a);
+    }
+    run.tick++;
+}
+
+// Everything typed since the last tick, with the moves netted out
+struct TickInput
+{
+    int dx, dy;
+    bool fire, quit;
+};
+
+// Drain every queued key, so a held key's repeats are used up each tick
+// instead of trickling in one per tick after it is let go
+TickInput read_input()
+{
+    TickInput in = {0, 0, false, false};
+    for (int ch = poll_input(); ch != NO_INPUT; ch = poll_input())
+    {
+        if (ch == 'q') in.quit = true;
+        else if (ch == 'h') in.dx--;
+        else if (ch == 'l') in.dx++;
+        else if (ch == 'j') in.dy++;
+        else if (ch == 'k') in.dy--;
+        else if (ch == ' ') in.fire = true;
+    }
+    in.dx = std::max(-SHIP_SPEED, std::min(in.dx, SHIP_SPEED));
+    in.dy = std::max(-SHIP_SPEED, std::min(in.dy, SHIP_SPEED));
+    return in;
+}
+
+// Note where everything starts the tick, so collisions can be tested along
+// the whole of each move rather than only where it ended
+void begin_tick()
+{
+    pool_begin_tick(bullets);
+    pool_begin_tick(enemies);
+    player_from_x = PLAYER_X;
+    player_from_y = PLAYER_Y;
 }
 
 void update_bullets()
 {
-    for (auto& b : bullets)
+    // Bullets that leave the field are freed by check_collisions(), after
+    // they had their chance to hit on the way out
+    for (int i = 0; i < bullets.count; ++i)
     {
-        if (b.active)
-        {
-            b.y--;
-            if (b.y < 1) b.active = false; // Top border is at 0
-        }
+        bullets.y[bullets.live[i]] -= BULLET_SPEED;
     }
-    bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
-                                 [](const Bullet& b) { return !b.active; }), bullets.end());
 }
 
 void update_enemies()
 {
-    tick_counter++;
-    // Move enemies
-    int speed = 5;
-    if (SCORE > 1000) speed = 4;
-    if (SCORE > 2000) speed = 3;
+    // Move the formation down, once the whole wave has spawned so that late
+    // enemies still join it on the field
+    if (!wave_spawning(campaign, run) && ++step_timer >= enemy_speed)
+    {
+        step_timer = 0;
+        formation_dy++;
+    }
 
-    if (tick_counter % speed == 0)
+    for (int i = 0; i < enemies.count; ++i)
     {
-        for (auto& e : enemies)
+        int id = enemies.live[i];
+        int target_y = slot_y[id] + formation_dy;
+        if (enemy_path[id] >= 0)
         {
-            if (e.active)
+            // One step along the path's table, relative to where the slot
+            // is now; back in formation at its end
+            const PathTable& path = path_table(enemy_path[id]);
+            int step = ++path_step[id];
+            if (step >= (int)path.dx.size() - 1)
+            {
+                enemy_mode[id] = MODE_FORMATION;
+                enemy_path[id] = -1;
+            }
+            else
             {
-                e.y++;
-                if (e.y >= GAME_HEIGHT - 1)
+                int x = slot_x[id] + fixed_to_cell(path.dx[step]);
+                int y = target_y + fixed_to_cell(path.dy[step]);
+                if (enemy_mode[id] == MODE_DIVING)
                 {
-                    // Reached bottom
-                    GAME_OVER = true;
+                    // Dives stay on the field, skimming the ship's row
+                    x = std::max(1, std::min(x, GAME_WIDTH - 2));
+                    y = std::max(1, std::min(y, GAME_HEIGHT - 1));
                 }
+                else
+                {
+                    // Entries may start off the sides or the top, but
+                    // never come down past the row above the ship's
+                    y = std::min(y, GAME_HEIGHT - 2);
+                }
+                enemies.x[id] = x;
+                enemies.y[id] = y;
+            }
+        }
+        else if (enemy_mode[id] == MODE_ENTERING)
+        {
+            // One row a tick, which outruns the formation
+            if (enemies.y[id] < target_y) enemies.y[id]++;
+            if (enemies.y[id] >= target_y) enemy_mode[id] = MODE_FORMATION;
+        }
+        if (enemy_mode[id] == MODE_FORMATION)
+        {
+            enemies.x[id] = slot_x[id];
+            enemies.y[id] = target_y;
+
+            if (enemies.y[id] >= GAME_HEIGHT - 1)
+            {
+                // Reached bottom
+                GAME_OVER = true;
             }
         }
     }
 }
 
-void check_collisions()
+// A live enemy that something moving from (x0, y0) to (x1, y1) this tick
+// ran into, or NO_ENTITY
+int enemy_hit(int x0, int y0, int x1, int y1)
 {
-    for (auto& b : bullets)
+    for (int y = std::min(y0, y1); y <= std::max(y0, y1); ++y)
     {
-        if (!b.active) continue;
-        for (auto& e : enemies)
+        for (int x = std::min(x0, x1); x <= std::max(x0, x1); ++x)
         {
-            if (!e.active) continue;
-            // Collision: Bullet at (x,y) hits Enemy at (x,y)
-            // Since x is discrete logic coord, exact match is fine.
-            if (b.x == e.x && b.y == e.y)
+            for (int n = grid_first(enemy_grid, x, y); n != NO_ENTITY; n = enemy_grid.next[n])
             {
-                b.active = false;
-                e.active = false;
-                SCORE += 100;
+                int e = enemy_grid.id[n];
+                if (pool_alive(enemies, e) &&
+                    swept_hit(x0, y0, x1, y1, enemies.from_x[e], enemies.from_y[e], enemies.x[e], enemies.y[e]))
+                {
+                    return e;
+                }
             }
         }
     }
+    return NO_ENTITY;
+}
 
-    // Check collision with player
-    for (const auto& e : enemies)
+void check_collisions()
+{
+    grid_clear(enemy_grid, GAME_WIDTH, GAME_HEIGHT);
+    for (int i = 0; i < enemies.count; ++i)
+    {
+        int id = enemies.live[i];
+        grid_insert(enemy_grid, enemies.from_x[id], enemies.from_y[id], enemies.x[id], enemies.y[id], id);
+    }
+
+    // Collision: a bullet hits an enemy whose cell it met at any moment of
+    // the tick, so the two cannot swap cells or pass through each other
+    for (int i = bullets.count - 1; i >= 0; --i)
     {
-        if (e.active && e.x == PLAYER_X && e.y == PLAYER_Y)
+        int b = bullets.live[i];
+        int e = enemy_hit(bullets.from_x[b], bullets.from_y[b], bullets.x[b], bullets.y[b]);
+        if (e != NO_ENTITY)
         {
-            GAME_OVER = true;
+            emit_explosion(particles, enemies.x[e], enemies.y[e]);
+            emit_sparks(particles, enemies.x[e], enemies.y[e]);
+            pool_kill(bullets, b);
+            pool_kill(enemies, e);
+            SCORE += 100;
+        }
+        else if (bullets.y[b] < 1)
+        {
+            pool_kill(bullets, b); // Top border is at 0
         }
     }
+
+    // Check collision with player
+    if (enemy_hit(player_from_x, player_from_y, PLAYER_X, PLAYER_Y) != NO_ENTITY) GAME_OVER = true;
 }
 
 void draw_game()
@@ -127,19 +320,27 @@ void draw_game()
     // height is GAME_HEIGHT
     draw_box(GAME_WIDTH, GAME_HEIGHT);
 
+    // Effects go under everything else
+    particles_draw(particles);
+
     // Draw Player
     draw_entity_colored(PLAYER_X, PLAYER_Y, "🚀", 6); // Cyan Ship
 
     // Draw Enemies
-    for (const auto& e : enemies)
+    for (int i = 0; i < enemies.count; ++i)
     {
-        if (e.active) draw_entity_colored(e.x, e.y, "👾", 5); // Magenta Aliens
+        int id = enemies.live[i];
+        // Enemies flying in start off the field
+        int x = enemies.x[id], y = enemies.y[id];
+        if (x < 1 || x > GAME_WIDTH - 2 || y < 1 || y > GAME_HEIGHT - 1) continue;
+        draw_entity_colored(x, y, "👾", 5); // Magenta Aliens
     }
 
     // Draw Bullets
-    for (const auto& b : bullets)
+    for (int i = 0; i < bullets.count; ++i)
     {
-        if (b.active) draw_entity_colored(b.x, b.y, "🔥", 3); // Yellow Fire
+        int id = bullets.live[i];
+        draw_entity_colored(bullets.x[id], bullets.y[id], "🔥", 3); // Yellow Fire
     }
 
     // UI Stats
@@ -148,6 +349,10 @@ void draw_game()
     ss << "Score: " << SCORE;
     draw_text_colored(2, uiY, ss.str(), 3); // Yellow
 
+    ss.str("");
+    ss << "Wave: " << (run.wave + 1);
+    draw_text_colored(44, uiY, ss.str(), 3);
+
     ss.str("");
     ss << "Lives: ";
     draw_text_colored(20, uiY, ss.str(), 3);
@@ -240,8 +445,36 @@ void game_over_screen()
     }
 }
 
+// The campaign file named on the command line, else the one shipped with
+// the game, else the built-in wave; false after printing why a script that
+// exists could not be used
+bool load_campaign(int argc, char** argv)
+{
+    std::string path = std::string(WAVES_LOCATION) + "/campaign.txt";
+    bool named = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--new-window") continue;
+        path = argv[i];
+        named = true;
+    }
+
+    if (!named && !std::ifstream(path.c_str()).good())
+    {
+        default_waves(campaign);
+        return true;
+    }
+
+    std::string error;
+    if (load_waves(path, campaign, error)) return true;
+    fprintf(stderr, "%s\n", error.c_str());
+    return false;
+}
+
 int galaga_main(int argc, char** argv)
 {
+    if (!load_campaign(argc, argv)) return 1;
+
     init_renderer();
 
     welcome_screen();
@@ -249,61 +482,50 @@ int galaga_main(int argc, char** argv)
     while (game_running)
     {
         reset_game();
-        spawn_enemies();
+        wave_start(campaign, run, 0);
+        reset_formation();
 
         while (!GAME_OVER)
         {
-            int ch = get_input(); // getch()
-            if (ch == 'q')
+            begin_tick();
+            auto tick_end = std::chrono::steady_clock::now() + std::chrono::milliseconds(TICK_MS);
+
+            TickInput in = read_input();
+            if (in.quit)
             {
                 GAME_OVER = true; // End round
             }
 
-            // Movement
-            if (ch == 'h')
-            {
-                if (PLAYER_X > 1) PLAYER_X--;
-            }
-            else if (ch == 'l')
-            {
-                if (PLAYER_X < GAME_WIDTH - 2) PLAYER_X++; // Boundary check adjusted for box
-            }
-            else if (ch == 'j')
-            {
-                if (PLAYER_Y < GAME_HEIGHT - 2) PLAYER_Y++; // Boundary check
-            }
-            else if (ch == 'k')
+            // Movement, boundaries adjusted for the box. The ship starts on
+            // the bottom row, which [j] cannot take it back to.
+            PLAYER_X = std::max(1, std::min(PLAYER_X + in.dx, GAME_WIDTH - 2));
+            if (in.dy < 0) PLAYER_Y = std::max(1, PLAYER_Y + in.dy);
+            if (in.dy > 0) PLAYER_Y = std::min(PLAYER_Y + in.dy, std::max(PLAYER_Y, GAME_HEIGHT - 2));
+
+            // Action
+            if (fire_cooldown > 0) fire_cooldown--;
+            if (in.fire && fire_cooldown == 0)
             {
-                if (PLAYER_Y > 1) PLAYER_Y--;
+                pool_spawn(bullets, PLAYER_X, PLAYER_Y - 1);
+                fire_cooldown = FIRE_COOLDOWN;
             }
-            // Action
-            else if (ch == ' ')
+
+            // Thruster puff where the ship left
+            if (PLAYER_X != player_from_x || PLAYER_Y != player_from_y)
             {
-                bullets.push_back({PLAYER_X, PLAYER_Y - 1, true});
+                int dx = (PLAYER_X > player_from_x) - (PLAYER_X < player_from_x);
+                int dy = (PLAYER_Y > player_from_y) - (PLAYER_Y < player_from_y);
+                emit_trail(particles, player_from_x, player_from_y, dx, dy);
             }
 
+            run_wave();
             update_bullets();
             update_enemies();
             check_collisions();
+            particles_update(particles);
             draw_game();
 
-            // Check wave clear
-            bool all_dead = true;
-            for (const auto& e : enemies)
-            {
-                if (e.active)
-                {
-                    all_dead = false;
-                    break;
-                }
-            }
-            if (all_dead)
-            {
-                spawn_enemies();
-                // Maybe increase difficulty/speed?
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            std::this_thread::sleep_until(tick_end);
         }
 
         game_over_screen();
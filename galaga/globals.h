@@ -13,4 +13,8 @@ extern int LIVES;
 extern bool GAME_OVER;
 extern bool VICTORY;
 
+#ifndef WAVES_LOCATION
+#define WAVES_LOCATION "waves"
+#endif
+
 #endif
\ No newline at end of file
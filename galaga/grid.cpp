@@ -0,0 +1,64 @@
+/*
+ * Galaga - Collision Grid
+ */
+
+#include "grid.h"
+#include <algorithm>
+
+void grid_clear(Grid& grid, int width, int height)
+{
+    grid.width = width;
+    grid.height = height;
+    grid.head.assign(width * height, NO_ENTITY);
+    grid.next.clear();
+    grid.id.clear();
+}
+
+void grid_insert(Grid& grid, int x0, int y0, int x1, int y1, int id)
+{
+    int left = std::max(0, std::min(x0, x1)), right = std::min(grid.width - 1, std::max(x0, x1));
+    int top = std::max(0, std::min(y0, y1)), bottom = std::min(grid.height - 1, std::max(y0, y1));
+    for (int y = top; y <= bottom; ++y)
+    {
+        for (int x = left; x <= right; ++x)
+        {
+            int cell = y * grid.width + x;
+            grid.next.push_back(grid.head[cell]);
+            grid.id.push_back(id);
+            grid.head[cell] = grid.id.size() - 1;
+        }
+    }
+}
+
+int grid_first(const Grid& grid, int x, int y)
+{
+    if (x < 0 || x >= grid.width || y < 0 || y >= grid.height) return NO_ENTITY;
+    return grid.head[y * grid.width + x];
+}
+
+// Times within the tick, as an open interval, at which an offset d + t*v
+// on one axis is less than a cell
+static void overlap_times(int d, int v, double& enter, double& exit)
+{
+    if (v == 0)
+    {
+        enter = d == 0 ? -1e9 : 1e9;
+        exit = d == 0 ? 1e9 : -1e9;
+        return;
+    }
+    double t1 = (-1.0 - d) / v, t2 = (1.0 - d) / v;
+    enter = std::min(t1, t2);
+    exit = std::max(t1, t2);
+}
+
+bool swept_hit(int ax0, int ay0, int ax1, int ay1, int bx0, int by0, int bx1, int by1)
+{
+    // b's motion as seen from a: the cells overlap while that offset is
+    // under one cell on both axes
+    double enter_x, exit_x, enter_y, exit_y;
+    overlap_times(bx0 - ax0, (bx1 - bx0) - (ax1 - ax0), enter_x, exit_x);
+    overlap_times(by0 - ay0, (by1 - by0) - (ay1 - ay0), enter_y, exit_y);
+
+    double enter = std::max(enter_x, enter_y), exit = std::min(exit_x, exit_y);
+    return enter < exit && enter < 1 && exit > 0;
+}
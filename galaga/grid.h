@@ -0,0 +1,44 @@
+/*
+ * Galaga - Collision Grid
+ *
+ * Enemies bucketed by the cells they crossed this tick, one list per cell
+ * of the play field. Rebuilt every tick in one pass over the enemies, so a
+ * bullet (or the ship) only looks at what shared a cell with its own path
+ * and a collision pass costs O(bullets + enemies) instead of
+ * O(bullets x enemies). swept_hit() then decides exactly.
+ */
+
+#ifndef GALAGA_GRID_H
+#define GALAGA_GRID_H
+
+#include <vector>
+
+const int NO_ENTITY = -1;
+
+struct Grid
+{
+    int width, height;
+    std::vector<int> head; // First entry in each cell, or NO_ENTITY
+    std::vector<int> next; // Next entry in the same cell, by entry
+    std::vector<int> id;   // Entity of each entry
+};
+
+// Empty every cell. The arrays keep their capacity, so after the first
+// ticks this allocates nothing.
+void grid_clear(Grid& grid, int width, int height);
+
+// Add entity 'id' to every cell of the box spanned by two positions, e.g.
+// where it was and where it is; cells outside the field are skipped
+void grid_insert(Grid& grid, int x0, int y0, int x1, int y1, int id);
+
+// First entry in the cell at x, y, then follow grid.next; NO_ENTITY when
+// the cell is empty or outside the field. An entity whose box covers
+// several cells of a query turns up once per cell.
+int grid_first(const Grid& grid, int x, int y);
+
+// Whether two cells moving in a straight line over the same tick, a from
+// (ax0, ay0) to (ax1, ay1) and b likewise, overlap at any moment of it.
+// Catches the two swapping cells or passing through each other.
+bool swept_hit(int ax0, int ay0, int ax1, int ay1, int bx0, int by0, int bx1, int by1);
+
+#endif
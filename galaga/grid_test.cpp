@@ -0,0 +1,87 @@
+/*
+ * Galaga - Collision Tests
+ *
+ * swept_hit() on the moves that slip past a test of end positions only:
+ * cells swapped, a bullet outrunning a row a tick, an enemy landing on the
+ * ship's row, and the grid finding what crossed a cell on the way.
+ */
+
+#include "grid.h"
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do                                                                \
+    {                                                                 \
+        if (!(cond))                                                  \
+        {                                                             \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+// A bullet and an enemy trading cells in one column meet halfway
+static void test_swap_in_column()
+{
+    CHECK(swept_hit(5, 10, 5, 9, 5, 9, 5, 10));
+    CHECK(swept_hit(5, 9, 5, 10, 5, 10, 5, 9));
+
+    // Side by side they pass
+    CHECK(!swept_hit(5, 10, 5, 9, 6, 9, 6, 10));
+}
+
+// A bullet climbing several rows a tick hits what was on the way
+static void test_fast_bullet()
+{
+    CHECK(swept_hit(5, 10, 5, 6, 5, 8, 5, 8));    // Still enemy
+    CHECK(swept_hit(5, 10, 5, 6, 5, 7, 5, 8));    // Enemy coming down
+    CHECK(swept_hit(5, 10, 5, 6, 4, 8, 5, 8));    // Enemy stepping in
+    CHECK(!swept_hit(5, 10, 5, 6, 6, 8, 6, 8));   // Next column
+    CHECK(!swept_hit(5, 10, 5, 6, 5, 3, 5, 4));   // Above where it stops
+    CHECK(!swept_hit(5, 10, 5, 6, 5, 11, 5, 12)); // Behind it
+}
+
+// A diving enemy reaching the ship's row hits the ship there, moving or not
+static void test_enemy_reaches_ship_row()
+{
+    CHECK(swept_hit(20, 19, 20, 19, 20, 17, 20, 19));
+    CHECK(swept_hit(18, 19, 20, 19, 20, 17, 20, 19));
+    CHECK(swept_hit(20, 19, 20, 19, 19, 18, 21, 20)); // Crossing the ship's cell
+    CHECK(!swept_hit(20, 19, 20, 19, 21, 17, 21, 19));
+    CHECK(!swept_hit(20, 19, 20, 19, 20, 16, 20, 18)); // One row short
+}
+
+// The grid files an enemy under every cell its move spans, so a bullet's
+// path finds it in a cell between where the enemy was and is
+static void test_grid_finds_crossed_cells()
+{
+    Grid grid;
+    grid_clear(grid, 40, 20);
+    grid_insert(grid, 5, 7, 5, 10, 3);
+    grid_insert(grid, 8, 2, 8, 2, 4);
+
+    CHECK(grid_first(grid, 5, 8) != NO_ENTITY && grid.id[grid_first(grid, 5, 8)] == 3);
+    CHECK(grid_first(grid, 5, 11) == NO_ENTITY);
+    CHECK(grid.id[grid_first(grid, 8, 2)] == 4);
+    CHECK(grid_first(grid, -1, 2) == NO_ENTITY);
+
+    grid_clear(grid, 40, 20);
+    CHECK(grid_first(grid, 5, 8) == NO_ENTITY);
+}
+
+int main()
+{
+    test_swap_in_column();
+    test_fast_bullet();
+    test_enemy_reaches_ship_row();
+    test_grid_finds_crossed_cells();
+
+    if (failures > 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All collision tests passed\n");
+    return 0;
+}
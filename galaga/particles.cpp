@@ -0,0 +1,157 @@
+/*
+ * Galaga - Particles
+ */
+
+#include "particles.h"
+#include "globals.h"
+#include "paths.h"
+#include "renderer.h"
+#include <algorithm>
+
+namespace
+{
+
+// Twelve directions round a circle at half a cell a tick, in fixed point
+const int BURST = 12;
+const int BURST_VX[BURST] = {128, 111, 64, 0, -64, -111, -128, -111, -64, 0, 64, 111};
+const int BURST_VY[BURST] = {0, 64, 111, 128, 111, 64, 0, -64, -111, -128, -111, -64};
+
+// Look of each kind as it ages: the glyph and color while life is at least
+// the stage's threshold, checked in order
+struct Stage
+{
+    int life;
+    char glyph;
+    int color;
+};
+const int STAGES = 3;
+const Stage LOOKS[PARTICLE_KINDS][STAGES] = {
+    {{6, '@', 3}, {3, '*', 1}, {0, '.', 1}}, // Explosion: yellow flash, red embers
+    {{3, '*', 7}, {1, '+', 3}, {0, '.', 3}}, // Spark: white, then yellow
+    {{2, ':', 6}, {1, '.', 6}, {0, '.', 4}}, // Trail: cyan, fading to blue
+};
+
+const Stage& look(const Particles& p, int i)
+{
+    const Stage* stages = LOOKS[p.kind[i]];
+    int s = 0;
+    while (s < STAGES - 1 && p.life[i] < stages[s].life) s++;
+    return stages[s];
+}
+
+// -range..range, from a cheap generator
+int scatter(Particles& p, int range)
+{
+    p.seed = p.seed * 1664525u + 1013904223u;
+    return (int)((p.seed >> 16) % (2 * range + 1)) - range;
+}
+
+void emit(Particles& p, int kind, int x, int y, int vx, int vy, int life)
+{
+    int i = p.next;
+    p.next = (p.next + 1) % MAX_PARTICLES;
+    p.x[i] = x * FIXED_ONE;
+    p.y[i] = y * FIXED_ONE;
+    p.vx[i] = vx;
+    p.vy[i] = vy;
+    p.life[i] = life;
+    p.kind[i] = kind;
+}
+
+} // namespace
+
+void particles_init(Particles& p)
+{
+    p.x.assign(MAX_PARTICLES, 0);
+    p.y.assign(MAX_PARTICLES, 0);
+    p.vx.assign(MAX_PARTICLES, 0);
+    p.vy.assign(MAX_PARTICLES, 0);
+    p.life.assign(MAX_PARTICLES, 0);
+    p.kind.assign(MAX_PARTICLES, PARTICLE_EXPLOSION);
+    p.seed = 1;
+    particles_clear(p);
+}
+
+void particles_clear(Particles& p)
+{
+    std::fill(p.life.begin(), p.life.end(), 0);
+    p.next = 0;
+}
+
+void emit_explosion(Particles& p, int x, int y)
+{
+    for (int i = 0; i < BURST; ++i)
+    {
+        emit(p, PARTICLE_EXPLOSION, x, y, BURST_VX[i] + scatter(p, 24), BURST_VY[i] + scatter(p, 24),
+             7 + scatter(p, 2));
+    }
+}
+
+void emit_sparks(Particles& p, int x, int y)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        emit(p, PARTICLE_SPARK, x, y, scatter(p, 160), -160 + scatter(p, 64), 4);
+    }
+}
+
+void emit_trail(Particles& p, int x, int y, int dx, int dy)
+{
+    emit(p, PARTICLE_TRAIL, x, y, -dx * 96 + scatter(p, 32), -dy * 96 + scatter(p, 32), 3);
+}
+
+void particles_update(Particles& p)
+{
+    for (int i = 0; i < MAX_PARTICLES; ++i)
+    {
+        if (p.life[i] == 0) continue;
+        p.x[i] += p.vx[i];
+        p.y[i] += p.vy[i];
+        p.life[i]--;
+    }
+}
+
+void particles_draw(const Particles& p)
+{
+    // Count the visible particles of each color, then lay them out color
+    // by color so each color is one renderer call
+    static std::vector<int> xs(MAX_PARTICLES), ys(MAX_PARTICLES);
+    static std::vector<char> glyphs(MAX_PARTICLES);
+    const int COLORS = 8;
+    int start[COLORS + 1] = {0};
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        int at[COLORS];
+        for (int c = 0; c < COLORS; ++c) at[c] = start[c];
+
+        for (int i = 0; i < MAX_PARTICLES; ++i)
+        {
+            if (p.life[i] == 0) continue;
+            int x = fixed_to_cell(p.x[i]), y = fixed_to_cell(p.y[i]);
+            if (x < 1 || x > GAME_WIDTH - 2 || y < 1 || y > GAME_HEIGHT - 1) continue;
+
+            const Stage& s = look(p, i);
+            if (pass == 0)
+            {
+                start[s.color + 1]++;
+                continue;
+            }
+            int k = at[s.color]++;
+            xs[k] = x;
+            ys[k] = y;
+            glyphs[k] = s.glyph;
+        }
+
+        if (pass == 0)
+        {
+            for (int c = 0; c < COLORS; ++c) start[c + 1] += start[c];
+        }
+    }
+
+    for (int c = 0; c < COLORS; ++c)
+    {
+        int n = start[c + 1] - start[c];
+        if (n > 0) draw_glyphs(&xs[start[c]], &ys[start[c]], &glyphs[start[c]], n, c);
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Galaga - Particles
+ *
+ * Explosions, hit sparks and thruster trails. Particles live in a ring of
+ * MAX_PARTICLES slots with one array per field, allocated once; a new
+ * particle takes the next slot whether or not it is still alive, so heavy
+ * combat cuts the oldest effects short instead of allocating or slowing
+ * the frame. Updating touches every slot with the same few operations and
+ * drawing sends one batch per color to the renderer, so the cost per tick
+ * is fixed.
+ */
+
+#ifndef GALAGA_PARTICLES_H
+#define GALAGA_PARTICLES_H
+
+#include <cstdint>
+#include <vector>
+
+const int MAX_PARTICLES = 512;
+
+enum ParticleKind
+{
+    PARTICLE_EXPLOSION,
+    PARTICLE_SPARK,
+    PARTICLE_TRAIL,
+    PARTICLE_KINDS
+};
+
+struct Particles
+{
+    std::vector<int> x, y, vx, vy; // Fixed point (paths.h), by slot
+    std::vector<uint8_t> life;     // Ticks left; 0 for a free slot
+    std::vector<uint8_t> kind;
+    int next;                      // Slot the next particle takes
+    uint32_t seed;                 // For a little scatter
+};
+
+void particles_init(Particles& p);
+void particles_clear(Particles& p);
+
+// Effects at a cell: a burst for a kill, a spray up from a bullet's hit,
+// and a puff behind a ship moving by dx, dy
+void emit_explosion(Particles& p, int x, int y);
+void emit_sparks(Particles& p, int x, int y);
+void emit_trail(Particles& p, int x, int y, int dx, int dy);
+
+void particles_update(Particles& p);
+void particles_draw(const Particles& p);
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Galaga - Flight Paths
+ */
+
+#include "paths.h"
+#include <cmath>
+
+namespace
+{
+
+struct Point
+{
+    double x, y;
+};
+
+// Cells an enemy covers per tick along a path
+const double PATH_SPEED = 0.8;
+// Samples per Bezier segment when measuring its length
+const int SEGMENT_SAMPLES = 64;
+// Control point distance for a quarter circle of radius 1
+const double ARC = 0.5523;
+
+struct PathSpec
+{
+    const char* name;
+    bool dive;
+    std::vector<Point> points; // p0, then three more per cubic segment
+};
+
+// In cells from the slot, y down. Entries come in from above the field,
+// swing under their slot and climb into it; dives peel off the formation,
+// sweep down at the ship and come back up.
+std::vector<PathSpec> specs()
+{
+    const double r = 3; // Loop radius
+    return {
+        {"swoop_left", false,
+         {{-22, -14}, {-14, -6}, {-12, 6}, {-4, 6},
+          {2, 6}, {6, 3}, {0, 0}}},
+        {"swoop_right", false,
+         {{22, -14}, {14, -6}, {12, 6}, {4, 6},
+          {-2, 6}, {-6, 3}, {0, 0}}},
+        {"loop", false,
+         {{0, -14}, {0, -8}, {0, 0}, {0, 6},
+          // A full circle to the right of the line, then up into the slot
+          {0, 6 + r * ARC}, {r - r * ARC, 6 + r}, {r, 6 + r},
+          {r + r * ARC, 6 + r}, {2 * r, 6 + r * ARC}, {2 * r, 6},
+          {2 * r, 6 - r * ARC}, {r + r * ARC, 6 - r}, {r, 6 - r},
+          {r - r * ARC, 6 - r}, {0, 4}, {0, 0}}},
+        {"dive_left", true,
+         {{0, 0}, {-1, -3}, {-6, -2}, {-7, 4},
+          {-8, 10}, {-2, 18}, {4, 16},
+          {8, 14}, {3, 4}, {0, 0}}},
+        {"dive_right", true,
+         {{0, 0}, {1, -3}, {6, -2}, {7, 4},
+          {8, 10}, {2, 18}, {-4, 16},
+          {-8, 14}, {-3, 4}, {0, 0}}},
+    };
+}
+
+Point bezier(const Point* p, double t)
+{
+    double u = 1 - t;
+    double a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+    return {a * p[0].x + b * p[1].x + c * p[2].x + d * p[3].x,
+            a * p[0].y + b * p[1].y + c * p[2].y + d * p[3].y};
+}
+
+// Walk the curve as a fine polyline, dropping a sample every PATH_SPEED
+// cells of length, so the enemy moves at an even pace however the control
+// points are spaced
+PathTable sample(const PathSpec& spec)
+{
+    std::vector<Point> line;
+    for (size_t s = 0; s + 3 < spec.points.size(); s += 3)
+    {
+        for (int i = s == 0 ? 0 : 1; i <= SEGMENT_SAMPLES; ++i)
+        {
+            line.push_back(bezier(&spec.points[s], (double)i / SEGMENT_SAMPLES));
+        }
+    }
+
+    PathTable table;
+    auto emit = [&table](const Point& p) {
+        table.dx.push_back((int16_t)std::lround(p.x * FIXED_ONE));
+        table.dy.push_back((int16_t)std::lround(p.y * FIXED_ONE));
+    };
+
+    emit(line[0]);
+    double carried = 0; // Length walked since the last sample
+    for (size_t i = 1; i < line.size(); ++i)
+    {
+        Point a = line[i - 1], b = line[i];
+        double len = std::hypot(b.x - a.x, b.y - a.y);
+        double at = PATH_SPEED - carried; // Next sample's distance into this piece
+        while (at <= len)
+        {
+            double t = at / len;
+            emit({a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t});
+            at += PATH_SPEED;
+        }
+        carried = len - (at - PATH_SPEED);
+    }
+    emit(line.back()); // Always finish exactly on the slot
+    return table;
+}
+
+} // namespace
+
+const PathTable& path_table(int path)
+{
+    static std::vector<PathTable> tables;
+    if (tables.empty())
+    {
+        for (const PathSpec& spec : specs())
+        {
+            tables.push_back(sample(spec));
+        }
+    }
+    return tables[path];
+}
+
+int path_by_name(const std::string& name, bool dive)
+{
+    std::vector<PathSpec> all = specs();
+    for (int i = 0; i < PATH_COUNT; ++i)
+    {
+        if (all[i].name == name && all[i].dive == dive) return i;
+    }
+    return -1;
+}
@@ -0,0 +1,51 @@
+/*
+ * Galaga - Flight Paths
+ *
+ * The curves enemies fly in by and dive along. Each is a chain of cubic
+ * Bezier segments, sampled once at startup into a table of positions one
+ * tick apart, evenly spaced along the curve. Positions are fixed point
+ * (FIXED_ONE to a cell) offsets from the enemy's formation slot, so an
+ * enemy on a path costs one table lookup a tick and the curve follows the
+ * formation as it comes down. Every path ends back on the slot, and dives
+ * start there too.
+ */
+
+#ifndef GALAGA_PATHS_H
+#define GALAGA_PATHS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const int FIXED_SHIFT = 8;
+const int FIXED_ONE = 1 << FIXED_SHIFT;
+
+enum PathId
+{
+    PATH_SWOOP_LEFT,  // Entries
+    PATH_SWOOP_RIGHT,
+    PATH_LOOP,
+    PATH_DIVE_LEFT,   // Dives
+    PATH_DIVE_RIGHT,
+    PATH_COUNT
+};
+
+struct PathTable
+{
+    std::vector<int16_t> dx, dy; // Offset from the slot at each tick
+};
+
+// Built on first use
+const PathTable& path_table(int path);
+
+// Path named in a wave script, or -1; dives are only found when 'dive' is
+// set, entries only when it is not
+int path_by_name(const std::string& name, bool dive);
+
+// Whole cell of a fixed-point coordinate, rounded to nearest
+inline int fixed_to_cell(int v)
+{
+    return (v + FIXED_ONE / 2) >> FIXED_SHIFT;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Galaga - Entity Pools
+ */
+
+#include "pool.h"
+
+void pool_init(Pool& pool, int capacity)
+{
+    pool.x.assign(capacity, 0);
+    pool.y.assign(capacity, 0);
+    pool.from_x.assign(capacity, 0);
+    pool.from_y.assign(capacity, 0);
+    pool.live.assign(capacity, 0);
+    pool.slot.assign(capacity, -1);
+    pool.free.reserve(capacity);
+    pool_clear(pool);
+}
+
+void pool_begin_tick(Pool& pool)
+{
+    for (int i = 0; i < pool.count; ++i)
+    {
+        int id = pool.live[i];
+        pool.from_x[id] = pool.x[id];
+        pool.from_y[id] = pool.y[id];
+    }
+}
+
+void pool_clear(Pool& pool)
+{
+    int capacity = pool_capacity(pool);
+    pool.free.clear();
+    for (int id = capacity - 1; id >= 0; --id)
+    {
+        pool.free.push_back(id); // Lowest ids are handed out first
+        pool.slot[id] = -1;
+    }
+    pool.count = 0;
+}
+
+int pool_spawn(Pool& pool, int x, int y)
+{
+    if (pool.free.empty()) return -1;
+
+    int id = pool.free.back();
+    pool.free.pop_back();
+    pool.x[id] = x;
+    pool.y[id] = y;
+    pool.from_x[id] = x;
+    pool.from_y[id] = y;
+    pool.live[pool.count] = id;
+    pool.slot[id] = pool.count;
+    pool.count++;
+    return id;
+}
+
+void pool_kill(Pool& pool, int id)
+{
+    int at = pool.slot[id];
+    if (at < 0) return;
+
+    int last = pool.live[--pool.count];
+    pool.live[at] = last;
+    pool.slot[last] = at;
+    pool.slot[id] = -1;
+    pool.free.push_back(id);
+}
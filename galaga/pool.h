@@ -0,0 +1,52 @@
+/*
+ * Galaga - Entity Pools
+ *
+ * Fixed-capacity storage for bullets and enemies. Coordinates live in
+ * parallel arrays indexed by entity id, free ids wait on a stack, and the
+ * live ids are kept packed so update and collision loops run over just
+ * the entities that exist. Nothing is allocated after pool_init(); a full
+ * pool refuses new entities instead of growing.
+ */
+
+#ifndef GALAGA_POOL_H
+#define GALAGA_POOL_H
+
+#include <vector>
+
+struct Pool
+{
+    std::vector<int> x, y;           // By entity id
+    std::vector<int> from_x, from_y; // Where each was when the tick began
+    std::vector<int> live;           // Ids in use, packed; the first 'count' are valid
+    std::vector<int> slot;           // Position of each id in live, -1 when free
+    std::vector<int> free;           // Ids not in use, as a stack
+    int count;
+};
+
+void pool_init(Pool& pool, int capacity);
+
+// Remember where every live entity is before the tick moves them, for
+// swept collision tests
+void pool_begin_tick(Pool& pool);
+
+// Free every entity
+void pool_clear(Pool& pool);
+
+// Id of a new entity at x, y, or -1 when the pool is full
+int pool_spawn(Pool& pool, int x, int y);
+
+// Free an entity. The last live id takes its place in 'live', so a loop
+// over live may kill the entity it is on if it runs from the end down.
+void pool_kill(Pool& pool, int id);
+
+inline bool pool_alive(const Pool& pool, int id)
+{
+    return pool.slot[id] >= 0;
+}
+
+inline int pool_capacity(const Pool& pool)
+{
+    return pool.x.size();
+}
+
+#endif
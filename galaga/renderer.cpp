@@ -70,6 +70,16 @@ void draw_text_centered_colored(int y, const std::string& text, int color)
     attroff(COLOR_PAIR(color));
 }
 
+void draw_glyphs(const int* x, const int* y, const char* glyphs, int count, int color)
+{
+    attron(COLOR_PAIR(color));
+    for (int i = 0; i < count; ++i)
+    {
+        mvaddch(y[i], x[i] * 2, glyphs[i]);
+    }
+    attroff(COLOR_PAIR(color));
+}
+
 void draw_box(int width, int height)
 {
     // Use width * 2 because of the spacing logic in draw_entity
@@ -106,4 +116,12 @@ void refresh_screen()
 int get_input()
 {
     return getch();
-}
\ No newline at end of file
+}
+
+int poll_input()
+{
+    nodelay(stdscr, TRUE);
+    int ch = getch();
+    timeout(50); // Back to get_input()'s delay
+    return ch;
+}
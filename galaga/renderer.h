@@ -11,9 +11,16 @@ void draw_text(int x, int y, const std::string& text);
 void draw_text_colored(int x, int y, const std::string& text, int color);
 void draw_text_centered(int y, const std::string& text);
 void draw_text_centered_colored(int y, const std::string& text, int color);
+// One character at each of count logical cells, all in one color
+void draw_glyphs(const int* x, const int* y, const char* glyphs, int count, int color);
 void draw_box(int width, int height);
 void clear_screen();
 void refresh_screen();
 int get_input();
+// get_input() result once its delay runs out, and poll_input()'s when no
+// key is waiting (ncurses ERR)
+const int NO_INPUT = -1;
+// A key already typed, or NO_INPUT at once
+int poll_input();
 
 #endif
\ No newline at end of file
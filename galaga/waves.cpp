@@ -0,0 +1,226 @@
+/*
+ * Galaga - Wave Scripts
+ */
+
+#include "waves.h"
+#include "globals.h"
+#include "paths.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+static const char* DEFAULT_WAVES =
+    "wave\n"
+    "formation 6 3 8 2 4 2\n"
+    "spawn 0 18 0 none\n"
+    "speed 0 5\n";
+
+int entry_by_name(const std::string& name)
+{
+    if (name == "none") return ENTRY_NONE;
+    if (name == "top") return ENTRY_TOP;
+    int path = path_by_name(name, false);
+    return path < 0 ? -1 : ENTRY_PATH + path;
+}
+
+// Sort the last wave's events by tick, keeping script order for ties, and
+// note where its spawns end
+static void close_wave(Campaign& campaign)
+{
+    int begin = campaign.waves.back();
+    std::stable_sort(campaign.events.begin() + begin, campaign.events.end(),
+                     [](const WaveEvent& a, const WaveEvent& b) { return a.tick < b.tick; });
+
+    int end = campaign.events.size();
+    while (end > begin && campaign.events[end - 1].op != WAVE_SPAWN) end--;
+    campaign.spawns_end.push_back(end);
+}
+
+bool compile_waves(std::istream& in, Campaign& campaign, std::string& error)
+{
+    campaign.events.clear();
+    campaign.waves.clear();
+    campaign.spawns_end.clear();
+
+    struct Slot
+    {
+        int x, y;
+    };
+    std::vector<Slot> slots; // The current wave's, in the order they fill
+    size_t next_slot = 0;
+
+    std::string line;
+    int line_no = 0;
+    int wave_line = 0;   // Where the current wave started
+    bool spawns = false; // Whether it spawns anything
+    auto fail_at = [&](int at, const std::string& message) {
+        std::stringstream ss;
+        ss << "line " << at << ": " << message;
+        error = ss.str();
+        return false;
+    };
+    auto fail = [&](const std::string& message) { return fail_at(line_no, message); };
+
+    while (std::getline(in, line))
+    {
+        line_no++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string cmd;
+        if (!(words >> cmd)) continue;
+
+        if (cmd == "wave")
+        {
+            // A wave with no enemies would be over as soon as it began
+            if (!campaign.waves.empty() && !spawns) return fail_at(wave_line, "wave has no spawns");
+            if (!campaign.waves.empty()) close_wave(campaign);
+            campaign.waves.push_back(campaign.events.size());
+            slots.clear();
+            next_slot = 0;
+            wave_line = line_no;
+            spawns = false;
+            continue;
+        }
+        if (campaign.waves.empty()) return fail("'" + cmd + "' before the first 'wave'");
+
+        int n[4];
+        std::string name, rest;
+        if (cmd == "formation")
+        {
+            int cols, rows, x, y, dx, dy;
+            if (!(words >> cols >> rows >> x >> y >> dx >> dy) || (words >> rest))
+            {
+                return fail("expected 'formation COLS ROWS X Y DX DY'");
+            }
+            for (int r = 0; r < rows; ++r)
+            {
+                for (int c = 0; c < cols; ++c)
+                {
+                    Slot s = {x + c * dx, y + r * dy};
+                    if (s.x < 1 || s.x > GAME_WIDTH - 2 || s.y < 1 || s.y > GAME_HEIGHT - 2)
+                    {
+                        return fail("formation slot off the field");
+                    }
+                    slots.push_back(s);
+                }
+            }
+        }
+        else if (cmd == "spawn")
+        {
+            if (!(words >> n[0] >> n[1] >> n[2] >> name) || (words >> rest))
+            {
+                return fail("expected 'spawn TICK COUNT EVERY ENTRY'");
+            }
+            int entry = entry_by_name(name);
+            if (entry < 0) return fail("unknown entry '" + name + "'");
+            if (n[0] < 0 || n[1] < 0 || n[2] < 0) return fail("negative spawn value");
+            if (next_slot + n[1] > slots.size()) return fail("more spawns than formation slots");
+
+            spawns = spawns || n[1] > 0;
+            for (int i = 0; i < n[1]; ++i)
+            {
+                const Slot& s = slots[next_slot++];
+                campaign.events.push_back({n[0] + i * n[2], WAVE_SPAWN, s.x, s.y, entry});
+            }
+        }
+        else if (cmd == "speed")
+        {
+            if (!(words >> n[0] >> n[1]) || (words >> rest)) return fail("expected 'speed TICK TICKS'");
+            if (n[0] < 0 || n[1] < 1) return fail("speed needs a tick >= 0 and TICKS >= 1");
+            campaign.events.push_back({n[0], WAVE_SPEED, n[1], 0, 0});
+        }
+        else if (cmd == "ramp")
+        {
+            if (!(words >> n[0] >> n[1] >> n[2] >> n[3]) || (words >> rest))
+            {
+                return fail("expected 'ramp T0 TICKS0 T1 TICKS1'");
+            }
+            if (n[0] < 0 || n[2] <= n[0] || n[1] < 1 || n[3] < 1)
+            {
+                return fail("ramp needs 0 <= T0 < T1 and TICKS >= 1");
+            }
+
+            // One speed event wherever the rounded speed changes
+            int last = 0;
+            for (int t = n[0]; t <= n[2]; ++t)
+            {
+                int ticks = std::lround(n[1] + (double)(n[3] - n[1]) * (t - n[0]) / (n[2] - n[0]));
+                if (ticks != last) campaign.events.push_back({t, WAVE_SPEED, ticks, 0, 0});
+                last = ticks;
+            }
+        }
+        else if (cmd == "dive")
+        {
+            if (!(words >> n[0] >> n[1] >> n[2] >> name) || (words >> rest))
+            {
+                return fail("expected 'dive TICK COUNT EVERY PATH'");
+            }
+            int path = path_by_name(name, true);
+            if (path < 0) return fail("unknown dive path '" + name + "'");
+            if (n[0] < 0 || n[1] < 0 || n[2] < 0) return fail("negative dive value");
+
+            for (int i = 0; i < n[1]; ++i)
+            {
+                campaign.events.push_back({n[0] + i * n[2], WAVE_DIVE, path, 0, 0});
+            }
+        }
+        else
+        {
+            return fail("unknown command '" + cmd + "'");
+        }
+    }
+
+    if (campaign.waves.empty())
+    {
+        error = "no waves";
+        return false;
+    }
+    if (!spawns) return fail_at(wave_line, "wave has no spawns");
+    close_wave(campaign);
+    campaign.waves.push_back(campaign.events.size());
+    return true;
+}
+
+bool load_waves(const std::string& path, Campaign& campaign, std::string& error)
+{
+    std::ifstream in(path.c_str());
+    if (!in.is_open())
+    {
+        error = "cannot read " + path;
+        return false;
+    }
+    if (compile_waves(in, campaign, error)) return true;
+    error = path + ": " + error;
+    return false;
+}
+
+void default_waves(Campaign& campaign)
+{
+    std::istringstream in(DEFAULT_WAVES);
+    std::string error;
+    compile_waves(in, campaign, error);
+}
+
+void wave_start(const Campaign& campaign, WaveRun& run, int w)
+{
+    run.wave = std::min(w, wave_count(campaign) - 1);
+    run.tick = 0;
+    run.next_event = campaign.waves[run.wave];
+}
+
+bool wave_begin_tick(const Campaign& campaign, WaveRun& run, int enemies_left)
+{
+    if (wave_spawning(campaign, run) || enemies_left > 0) return false;
+    wave_start(campaign, run, run.wave + 1);
+    return true;
+}
+
+const WaveEvent* wave_next_event(const Campaign& campaign, WaveRun& run)
+{
+    if (run.next_event == campaign.waves[run.wave + 1]) return nullptr;
+    const WaveEvent& e = campaign.events[run.next_event];
+    if (e.tick > run.tick) return nullptr;
+    run.next_event++;
+    return &e;
+}
@@ -0,0 +1,107 @@
+/*
+ * Galaga - Wave Scripts
+ *
+ * A campaign is a text file of waves, one command per line, '#' starting
+ * a comment. Ticks count from the start of their wave.
+ *
+ *   wave                          start the next wave
+ *   formation C R X Y DX DY       C x R slots, the first at X, Y, then
+ *                                 every DX columns and DY rows
+ *   spawn T N EVERY ENTRY         fill the next N free slots, one every
+ *                                 EVERY ticks from tick T, each flying in
+ *                                 by ENTRY (see entry_by_name())
+ *   speed T TICKS                 from tick T the formation steps down a
+ *                                 row every TICKS ticks
+ *   ramp T0 TICKS0 T1 TICKS1      speed going linearly from TICKS0 at T0
+ *                                 to TICKS1 at T1
+ *   dive T N EVERY PATH           from tick T, every EVERY ticks, the
+ *                                 enemy in formation nearest the ship's
+ *                                 column dives along PATH, N times
+ *
+ * Entries are 'none', 'top' or an entry path (swoop_left, swoop_right,
+ * loop); dive paths are dive_left and dive_right. See paths.h. Every wave
+ * must spawn at least one enemy.
+ *
+ * Loading compiles it into one flat list of events per wave, sorted by
+ * tick, so the game only ever looks at the next event whatever the script
+ * does. A wave ends once its last enemy has spawned and been shot down,
+ * whatever speed or dive events it has left, and the next one starts on
+ * the following tick; after the last, the last wave repeats.
+ */
+
+#ifndef GALAGA_WAVES_H
+#define GALAGA_WAVES_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+enum WaveOp
+{
+    WAVE_SPAWN, // An enemy for the slot at a, b, flying in by entry c
+    WAVE_SPEED, // The formation steps down every a ticks
+    WAVE_DIVE,  // An enemy in formation dives along path a
+};
+
+enum Entry
+{
+    ENTRY_NONE, // Appears in its slot
+    ENTRY_TOP,  // Drops from the top row straight down to its slot
+    ENTRY_PATH, // ENTRY_PATH + n: flies in along path n
+};
+
+struct WaveEvent
+{
+    int tick;
+    WaveOp op;
+    int a, b, c;
+};
+
+struct Campaign
+{
+    std::vector<WaveEvent> events; // Every wave's, one after the other
+    std::vector<int> waves;        // Where each wave's events start, then the end
+    std::vector<int> spawns_end;   // Per wave, one past its last spawn event
+};
+
+// How far the game is through a campaign
+struct WaveRun
+{
+    int wave;       // Index in the campaign
+    int tick;       // Ticks since the wave started
+    int next_event; // First event of the wave not applied yet
+};
+
+// Entry named in a script, or -1
+int entry_by_name(const std::string& name);
+
+// False with a 'line N: ...' message when the script has an error
+bool compile_waves(std::istream& in, Campaign& campaign, std::string& error);
+
+bool load_waves(const std::string& path, Campaign& campaign, std::string& error);
+
+// The one wave the game had before campaigns: a 6 x 3 block, in place
+void default_waves(Campaign& campaign);
+
+inline int wave_count(const Campaign& campaign)
+{
+    return campaign.waves.size() - 1;
+}
+
+// Start wave w, or the last one past the end
+void wave_start(const Campaign& campaign, WaveRun& run, int w);
+
+// At the start of a tick, move on to the next wave if this one has nothing
+// left to spawn and enemies_left is 0; true when it did
+bool wave_begin_tick(const Campaign& campaign, WaveRun& run, int enemies_left);
+
+// The next event due by run.tick, or nullptr once the rest are later
+const WaveEvent* wave_next_event(const Campaign& campaign, WaveRun& run);
+
+// True while the wave still has enemies to spawn
+inline bool wave_spawning(const Campaign& campaign, const WaveRun& run)
+{
+    return run.next_event < campaign.spawns_end[run.wave];
+}
+
+#endif
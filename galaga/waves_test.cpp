@@ -0,0 +1,167 @@
+/*
+ * Galaga - Wave Script Tests
+ *
+ * Plays compiled campaigns the way run_wave() does, with the enemies
+ * reduced to a count, and checks when waves hand over.
+ */
+
+#include "waves.h"
+#include <cstdio>
+#include <sstream>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do                                                                \
+    {                                                                 \
+        if (!(cond))                                                  \
+        {                                                             \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+static Campaign compile(const char* script)
+{
+    Campaign campaign;
+    std::istringstream in(script);
+    std::string error;
+    if (!compile_waves(in, campaign, error)) fprintf(stderr, "%s\n", error.c_str());
+    return campaign;
+}
+
+// One tick of run_wave(): true when a new wave started, with the spawns
+// and dives it applied added up
+static bool tick(const Campaign& campaign, WaveRun& run, int& enemies, int& dives)
+{
+    bool started = wave_begin_tick(campaign, run, enemies);
+    while (const WaveEvent* e = wave_next_event(campaign, run))
+    {
+        if (e->op == WAVE_SPAWN) enemies++;
+        else if (e->op == WAVE_DIVE) dives++;
+    }
+    run.tick++;
+    return started;
+}
+
+// Speed and dive events after the last spawn do not hold a cleared wave
+// open: the next one starts on the tick after its last enemy died
+static void test_cleared_wave_hands_over()
+{
+    Campaign campaign = compile("wave\n"
+                                "formation 3 1 5 2 4 0\n"
+                                "spawn 0 3 2 none\n"
+                                "speed 100 3\n"
+                                "dive 200 5 40 dive_left\n"
+                                "wave\n"
+                                "formation 1 1 5 2 4 0\n"
+                                "spawn 0 1 0 top\n");
+    CHECK(wave_count(campaign) == 2);
+
+    WaveRun run;
+    wave_start(campaign, run, 0);
+    int enemies = 0, dives = 0;
+    for (int t = 0; t < 10; ++t)
+    {
+        CHECK(!tick(campaign, run, enemies, dives));
+    }
+    CHECK(enemies == 3);
+    CHECK(!wave_spawning(campaign, run));
+
+    enemies = 0; // All shot down this tick
+    CHECK(tick(campaign, run, enemies, dives));
+    CHECK(run.wave == 1);
+    CHECK(enemies == 1); // Its tick 0 spawn came on the same tick
+    CHECK(dives == 0);
+}
+
+// A wave with enemies still to spawn goes on with none alive
+static void test_spawning_wave_waits()
+{
+    Campaign campaign = compile("wave\n"
+                                "formation 2 1 5 2 4 0\n"
+                                "spawn 0 1 0 none\n"
+                                "spawn 50 1 0 none\n"
+                                "wave\n"
+                                "formation 1 1 5 2 4 0\n"
+                                "spawn 0 1 0 none\n");
+
+    WaveRun run;
+    wave_start(campaign, run, 0);
+    int enemies = 0, dives = 0;
+    tick(campaign, run, enemies, dives);
+    enemies = 0;
+    for (int t = 1; t < 50; ++t)
+    {
+        CHECK(!tick(campaign, run, enemies, dives));
+        CHECK(wave_spawning(campaign, run));
+    }
+    CHECK(!tick(campaign, run, enemies, dives));
+    CHECK(run.wave == 0);
+    CHECK(enemies == 1);
+    CHECK(!wave_spawning(campaign, run));
+}
+
+// After the last wave, the last wave repeats
+static void test_last_wave_repeats()
+{
+    Campaign campaign = compile("wave\n"
+                                "formation 1 1 5 2 4 0\n"
+                                "spawn 0 1 0 none\n"
+                                "dive 30 1 0 dive_right\n");
+
+    WaveRun run;
+    wave_start(campaign, run, 0);
+    int enemies = 0, dives = 0;
+    tick(campaign, run, enemies, dives);
+    enemies = 0;
+    CHECK(tick(campaign, run, enemies, dives));
+    CHECK(run.wave == 0);
+    CHECK(run.tick == 1);
+    CHECK(enemies == 1);
+}
+
+// A wave that spawns nothing is an error at its 'wave' line, wherever it is
+static void test_empty_wave_rejected()
+{
+    const char* scripts[] = {
+        "wave\n"
+        "formation 1 1 5 2 4 0\n"
+        "spawn 0 1 0 none\n"
+        "wave\n"
+        "speed 0 3\n"
+        "dive 10 2 5 dive_left\n",
+
+        "wave\n"
+        "formation 1 1 5 2 4 0\n"
+        "spawn 0 0 0 none\n"
+        "wave\n"
+        "formation 1 1 5 2 4 0\n"
+        "spawn 0 1 0 none\n",
+    };
+    const char* errors[] = {"line 4: wave has no spawns", "line 1: wave has no spawns"};
+    for (int i = 0; i < 2; ++i)
+    {
+        Campaign campaign;
+        std::istringstream in(scripts[i]);
+        std::string error;
+        CHECK(!compile_waves(in, campaign, error));
+        CHECK(error == errors[i]);
+    }
+}
+
+int main()
+{
+    test_cleared_wave_hands_over();
+    test_spawning_wave_waits();
+    test_last_wave_repeats();
+    test_empty_wave_rejected();
+
+    if (failures > 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All wave tests passed\n");
+    return 0;
+}
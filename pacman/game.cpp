@@ -20,11 +20,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 #include <iostream>
 #include <clocale>
+#include <sstream>
 
 #include "globals.h"
 #include "helperFns.h"
 #include "avatar.h"
 #include "ghost1.h"
+#include "motionIndex.h"
+#include "common/levelpack.h"
 
 using namespace std;
 
@@ -40,6 +43,9 @@ struct ghostInfo {
 };
 vector<ghostInfo> ghostList;
 
+// every level's map text, from maps.pack or the map files
+LevelPack levels;
+
 
 void gotoLineBeginning(int line, avatar &unit) {
 	int x = 0;
@@ -66,9 +72,16 @@ bool isFullDigits(string &str) {
 	return true;
 }
 
+// true while INPUT holds f/F/t/T (with an optional count) waiting for its character
+bool isPendingFind(string &str) {
+	if(str.empty() || string("fFtT").find(str.back()) == string::npos)
+		return false;
+	string count = str.substr(0, str.size() - 1);
+	return isFullDigits(count);
+}
 
-
-void doKeystroke(avatar& unit) {
+// count only applies to f/F/t/T, which search for the count-th match at once
+void doKeystroke(avatar& unit, int count = 1) {
 	if(INPUT== "q") { 
 		endwin();
 		exit(0);
@@ -139,6 +152,32 @@ void doKeystroke(avatar& unit) {
 			unit.parseWordForward(true);
 		}
 	}
+	else if(INPUT.size() == 2 && string("fFtT").find(INPUT[0]) != string::npos) {
+		// f/F land on the character, t/T stop one short of it
+		bool forward = (INPUT[0] == 'f' || INPUT[0] == 't');
+		int col = findInRow(unit.getY(), unit.getX(), INPUT[1], forward, count);
+		if(col != -1) {
+			if(INPUT[0] == 't') col--;
+			else if(INPUT[0] == 'T') col++;
+
+			// walk there so the letters on the way are eaten, like w does
+			while(unit.getX() < col && GAME_WON == 0 && unit.moveRight());
+			while(unit.getX() > col && GAME_WON == 0 && unit.moveLeft());
+		}
+	}
+	else if(INPUT == "%") {
+		int x, y;
+		if(matchBracket(unit.getX(), unit.getY(), x, y)) {
+			unit.moveTo(x, y);
+		}
+	}
+	else if(INPUT == "}" || INPUT == "{") {
+		int row = (INPUT == "}") ? nextParagraph(unit.getY()) : prevParagraph(unit.getY());
+		int col = rowStart(row);
+		if(col != -1) {
+			unit.moveTo(col, row);
+		}
+	}
 	else if(INPUT == "&") {
 		GAME_WON = 1; // l337 cheetz
 	}
@@ -153,6 +192,21 @@ void onKeystroke(avatar& unit, char key) {
 	// 1. #G [moves to line #]
 	// 2. 1G = same as gg
 	// 3. gg = beginning of file... it's weird bc it's two non-digit characters
+	// 4. f/F/t/T take the next key as their argument, even g or a digit
+
+	if(isPendingFind(INPUT)) {
+		int num = 1;
+		if(INPUT.size() > 1)
+			num = std::stoi(INPUT.substr(0, INPUT.size() - 1), nullptr, 0);
+
+		// one search for the num-th match, so t/T step back from it only once
+		INPUT = INPUT.substr(INPUT.size() - 1) + key;
+		doKeystroke(unit, num);
+		INPUT = "";
+		refresh();
+		mtx.unlock();
+		return;
+	}
 
 	// If INPUT != empty, and the user inputs a number, INPUT
 	// should reset.. EG: 3g3 dd = 1 dd, not 3 dd
@@ -203,6 +257,14 @@ void onKeystroke(avatar& unit, char key) {
 			mtx.unlock();
 			return;
 		}
+		// 3fa -- keep the count and wait for the character to find
+		if(string("fFtT").find(key) != string::npos) {
+			INPUT += key;
+			refresh();
+			mtx.unlock();
+			return;
+		}
+
 		// if the input is NOT G, then it means
 		// we are repeating a keystroke.. eg 3w = w, three times
 	
@@ -218,7 +280,10 @@ void onKeystroke(avatar& unit, char key) {
 
 		// do keystroke if the first character is a letter,
 		//  except 0 (which immediately moves the player)
-		if(INPUT == "0" || !isFullDigits(INPUT)) {
+		if(isPendingFind(INPUT)) {
+			// wait for the character to find
+		}
+		else if(INPUT == "0" || !isFullDigits(INPUT)) {
 			doKeystroke(unit);
 			INPUT = "";
 		}
@@ -272,13 +337,13 @@ void drawVimKeys(int y, int x) {
 }
 
 // loads the level, essentially
-void drawScreen(const char* file) {
+void drawScreen(const string& mapText) {
 	levelMessage();
 	// clear(); // Commented out clear()
 	
 	writeError("DRAWING THE SCREEN");
 
-	ifstream in(file);
+	istringstream in(mapText);
 
 	// clear ghostList because we are gonna obtain new ones
 	ghostList.clear();
@@ -312,7 +377,6 @@ void drawScreen(const char* file) {
 			board.at(i).push_back(empty);
 		}
 	}
-	in.close();
 
 	GAME_BOARD = boardStr;
 
@@ -541,13 +605,14 @@ void playGame(time_t lastTime, avatar &player) {
 }
 
 
-void init(const char* mapName) {
+void init(const string& mapText) {
 	// set up map
 	clear();
 	TOP = 0;
 	BOTTOM = 0;
 	WIDTH = 0;
-	drawScreen(mapName);
+	drawScreen(mapText);
+	buildMotionIndex(TOP);
 
 	// create player
 	avatar player (START_X, START_Y, true);
@@ -636,6 +701,11 @@ int pacvim_main(int argc, char** argv)
 	defineColors();
 	noecho(); // dont print anything to the screen
 
+	// the level count comes from the pack (or map files) on disk
+	if (levels.load(MAPS_LOCATION)) {
+		NUM_OF_LEVELS = levels.count() - 1;
+	}
+
 	// Look for cmd line args
 	// Any cmd line args will change the CURRENT_LEVEL
 	// at the start of the game.
@@ -648,15 +718,7 @@ int pacvim_main(int argc, char** argv)
 	}
 
 	while(LIVES >= 0) {
-		string mapName = MAPS_LOCATION "/map";
-		
-		// convert CURRENT_LEVEL to string, and load
-		std::stringstream ss;
-		ss << CURRENT_LEVEL;
-		
-		mapName += ss.str(); // add it to mapName
-		mapName += ".txt"; // must be .txt
-		init(mapName.c_str());
+		init(levels.text(CURRENT_LEVEL));
 		if(GAME_WON == -1) {
 			CURRENT_LEVEL--;
 			GAME_WON = 0;
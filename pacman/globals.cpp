@@ -26,7 +26,7 @@ int GAME_WON = 0;
 std::string INPUT = "";
 bool READY = false;
 int LIVES = 3;
-const int NUM_OF_LEVELS = 9;
+int NUM_OF_LEVELS = 9;
 
 double THINK_MULTIPLIER = 1.0;
 
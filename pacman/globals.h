@@ -39,7 +39,7 @@ extern int GAME_WON; // 0 = in progress, 1 = won, -1 = lose
 extern std::string INPUT; // keyboard characters
 extern int CURRENT_LEVEL;
 extern int LIVES;
-extern const int NUM_OF_LEVELS;
+extern int NUM_OF_LEVELS; // index of the last level, set from the level pack
 
 extern bool READY;
 extern double THINK_MULTIPLIER; // all the think times for the AI are multipled by this
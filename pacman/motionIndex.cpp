@@ -0,0 +1,153 @@
+/*
+ * PacVim - Motion Indexes
+ */
+
+#include "globals.h"
+#include "motionIndex.h"
+#include <array>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// charCols[y][c] = columns of character c on row y, ascending
+static std::vector<std::array<std::vector<int>, 128> > charCols;
+
+// per cell (y * cols + x): partner of a bracket, and the first bracket
+// at or after that cell on the same row (-1 if none)
+static std::vector<int> bracketMatch;
+static std::vector<int> nextBracket;
+static int cols = 0;
+
+// per row: next/previous paragraph boundary and first playable column
+static std::vector<int> nextPara;
+static std::vector<int> prevPara;
+static std::vector<int> firstCol;
+
+static int openerOf(char c) {
+	if(c == ')') return '(';
+	if(c == ']') return '[';
+	if(c == '}') return '{';
+	return 0;
+}
+
+static bool isBracket(char c) {
+	return c == '(' || c == '[' || c == '{' || openerOf(c) != 0;
+}
+
+// a line is a paragraph boundary when it holds nothing but walls and spaces
+static bool isBlankRow(const std::string &row) {
+	for(unsigned i = 0; i < row.size(); i++) {
+		if(row[i] != ' ' && row[i] != '#')
+			return false;
+	}
+	return true;
+}
+
+void buildMotionIndex(int rows) {
+	rows = std::min(rows, (int)GAME_BOARD.size());
+	cols = 0;
+	for(int y = 0; y < rows; y++)
+		cols = std::max(cols, (int)GAME_BOARD[y].size());
+
+	charCols.assign(rows, std::array<std::vector<int>, 128>());
+	bracketMatch.assign(rows * cols, -1);
+	nextBracket.assign(rows * cols, -1);
+	firstCol.assign(rows, -1);
+	nextPara.assign(rows, -1);
+	prevPara.assign(rows, -1);
+
+	// brackets of each kind pair up in reading order, across lines like vim
+	std::vector<int> open[128];
+
+	for(int y = 0; y < rows; y++) {
+		const std::string &row = GAME_BOARD[y];
+		for(int x = 0; x < (int)row.size(); x++) {
+			unsigned char c = row[x];
+			if(c >= 128)
+				continue;
+			charCols[y][c].push_back(x);
+
+			if(c == '(' || c == '[' || c == '{') {
+				open[c].push_back(y * cols + x);
+			}
+			else if(openerOf(c) && !open[openerOf(c)].empty()) {
+				int partner = open[openerOf(c)].back();
+				open[openerOf(c)].pop_back();
+				bracketMatch[y * cols + x] = partner;
+				bracketMatch[partner] = y * cols + x;
+			}
+		}
+
+		int next = -1;
+		for(int x = cols - 1; x >= 0; x--) {
+			if(x < (int)row.size() && isBracket(row[x]))
+				next = y * cols + x;
+			nextBracket[y * cols + x] = next;
+		}
+
+		// skip the margin and the outer wall to find the first cell inside
+		size_t x = row.find_first_not_of(' ');
+		x = row.find_first_not_of('#', x == std::string::npos ? row.size() : x);
+		size_t lastWall = row.find_last_of('#');
+		if(x != std::string::npos && lastWall != std::string::npos && x < lastWall)
+			firstCol[y] = x;
+	}
+
+	int firstRow = 0, lastRow = rows - 1;
+	while(firstRow < rows && firstCol[firstRow] == -1) firstRow++;
+	while(lastRow >= 0 && firstCol[lastRow] == -1) lastRow--;
+
+	int boundary = lastRow;
+	for(int y = rows - 1; y >= 0; y--) {
+		nextPara[y] = boundary;
+		if(firstCol[y] != -1 && isBlankRow(GAME_BOARD[y]))
+			boundary = y;
+	}
+	boundary = firstRow;
+	for(int y = 0; y < rows; y++) {
+		prevPara[y] = boundary;
+		if(firstCol[y] != -1 && isBlankRow(GAME_BOARD[y]))
+			boundary = y;
+	}
+}
+
+int findInRow(int y, int x, char c, bool forward, int count) {
+	if(y < 0 || y >= (int)charCols.size() || (unsigned char)c >= 128 || count < 1)
+		return -1;
+	const std::vector<int> &pos = charCols[y][(unsigned char)c];
+	if(forward) {
+		std::vector<int>::const_iterator it = std::upper_bound(pos.begin(), pos.end(), x);
+		return pos.end() - it < count ? -1 : *(it + (count - 1));
+	}
+	std::vector<int>::const_iterator it = std::lower_bound(pos.begin(), pos.end(), x);
+	return it - pos.begin() < count ? -1 : *(it - count);
+}
+
+bool matchBracket(int x, int y, int &mx, int &my) {
+	if(y < 0 || x < 0 || y >= (int)charCols.size() || x >= cols)
+		return false;
+	int from = nextBracket[y * cols + x];
+	if(from == -1 || bracketMatch[from] == -1)
+		return false;
+	mx = bracketMatch[from] % cols;
+	my = bracketMatch[from] / cols;
+	return true;
+}
+
+int nextParagraph(int y) {
+	if(y < 0 || y >= (int)nextPara.size())
+		return y;
+	return nextPara[y];
+}
+
+int prevParagraph(int y) {
+	if(y < 0 || y >= (int)prevPara.size())
+		return y;
+	return prevPara[y];
+}
+
+int rowStart(int y) {
+	if(y < 0 || y >= (int)firstCol.size())
+		return -1;
+	return firstCol[y];
+}
@@ -0,0 +1,29 @@
+/*
+ * PacVim - Motion Indexes
+ *
+ * Lookup tables for the motions that search the board (f/F/t/T, %, { and }).
+ * They are built once per level from GAME_BOARD, so a keystroke never has
+ * to scan curses cells to find where it lands.
+ */
+
+#ifndef MOTIONINDEX_H
+#define MOTIONINDEX_H
+
+// Build every table for the first 'rows' lines of GAME_BOARD
+void buildMotionIndex(int rows);
+
+// Column of the count-th next (forward) or previous 'c' on row y, strictly
+// past x; -1 if there are fewer
+int findInRow(int y, int x, char c, bool forward, int count = 1);
+
+// Position of the bracket matching the first bracket at or after x on row y
+bool matchBracket(int x, int y, int &mx, int &my);
+
+// Row of the next/previous blank line, or the last/first board row if there is none
+int nextParagraph(int y);
+int prevParagraph(int y);
+
+// First column of row y that is inside the walls; -1 if the row has none
+int rowStart(int y);
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Sokoban - Auto-Walk
+ */
+
+#include "autowalk.h"
+#include <cstdint>
+#include <vector>
+
+static const int DIR_X[4] = {-1, 0, 0, 1};
+static const int DIR_Y[4] = {0, 1, -1, 0};
+static const char DIR_KEY[4] = {'h', 'j', 'k', 'l'};
+
+static const uint16_t FAR = 0xFFFF;
+
+// Distance from every cell to the nearest goal, and the planes it was
+// built from; it stays valid while they are unchanged
+struct DistanceField
+{
+    std::vector<Word> walls, targets, blocks;
+    std::vector<uint16_t> dist;
+};
+
+static bool is_goal(const Level& level, const State& state, int cell, char kind)
+{
+    bool block = test_bit(state.blocks, cell);
+    bool target = test_bit(level.targets, cell);
+    return kind == 'b' ? block && !target : target && !block;
+}
+
+static void build(DistanceField& field, const Level& level, const State& state, char kind)
+{
+    field.walls = level.walls;
+    field.targets = level.targets;
+    field.blocks = state.blocks;
+
+    int cells = level.width * level.height;
+    field.dist.assign(cells, FAR);
+    std::vector<int> queue;
+    queue.reserve(cells);
+
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        if (!test_bit(level.walls, cell) && is_goal(level, state, cell, kind))
+        {
+            field.dist[cell] = 0;
+            queue.push_back(cell);
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        int cell = queue[head];
+        int x = cell % level.width, y = cell / level.width;
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = x + DIR_X[d], ny = y + DIR_Y[d];
+            if (!in_bounds(level, nx, ny)) continue;
+
+            int next = cell_index(level, nx, ny);
+            if (field.dist[next] != FAR || test_bit(level.walls, next)) continue;
+            field.dist[next] = field.dist[cell] + 1;
+            queue.push_back(next);
+        }
+    }
+}
+
+std::string walk_to_nearest(const Level& level, const State& state, char kind)
+{
+    static DistanceField blocks_field, targets_field;
+    DistanceField& field = kind == 'b' ? blocks_field : targets_field;
+
+    // A pick or a put (or a new level) changes the planes
+    if (field.blocks != state.blocks || field.walls != level.walls || field.targets != level.targets)
+    {
+        build(field, level, state, kind);
+    }
+
+    std::string steps;
+    int x = state.px, y = state.py;
+    uint16_t here = field.dist[cell_index(level, x, y)];
+
+    // A level may start the player on a wall, which has no distance; step
+    // off it towards the nearest goal first
+    if (test_bit(level.walls, cell_index(level, x, y)))
+    {
+        int best = -1;
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = x + DIR_X[d], ny = y + DIR_Y[d];
+            if (!in_bounds(level, nx, ny)) continue;
+
+            uint16_t dist = field.dist[cell_index(level, nx, ny)];
+            if (dist != FAR && (best < 0 || dist < field.dist[cell_index(level, x + DIR_X[best], y + DIR_Y[best])]))
+            {
+                best = d;
+            }
+        }
+        if (best < 0) return steps;
+
+        steps += DIR_KEY[best];
+        x += DIR_X[best];
+        y += DIR_Y[best];
+        here = field.dist[cell_index(level, x, y)];
+    }
+    if (here == FAR) return steps;
+
+    while (here > 0)
+    {
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = x + DIR_X[d], ny = y + DIR_Y[d];
+            if (!in_bounds(level, nx, ny) || field.dist[cell_index(level, nx, ny)] != here - 1) continue;
+
+            steps += DIR_KEY[d];
+            x = nx;
+            y = ny;
+            here--;
+            break;
+        }
+    }
+    return steps;
+}
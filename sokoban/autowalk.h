@@ -0,0 +1,22 @@
+/*
+ * Sokoban - Auto-Walk
+ *
+ * Shortest walks to the nearest loose block or empty target, for gb/gt.
+ * The player walks over everything but walls, so the walkable floor never
+ * changes during a level; only the goals move. Each kind of goal keeps a
+ * multi-source BFS distance field over the floor that is rebuilt only
+ * after a block is picked up or placed. Every other query just walks
+ * downhill from the player, in time proportional to the path.
+ */
+
+#ifndef SOKOBAN_AUTOWALK_H
+#define SOKOBAN_AUTOWALK_H
+
+#include "board.h"
+#include <string>
+
+// Steps (h j k l) to the nearest cell of a kind: 'b' a loose block, 't' an
+// empty target. Empty when the player is on one or none can be reached.
+std::string walk_to_nearest(const Level& level, const State& state, char kind);
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Sokoban - Board Representation
+ */
+
+#include "board.h"
+#include <fstream>
+
+void read_map(std::istream& in, std::vector<std::string>& rows, int& start_x, int& start_y)
+{
+    rows.clear();
+    std::string line;
+    size_t width = 0;
+
+    while (std::getline(in, line))
+    {
+        // Check for player position line (starts with 'p')
+        if (!line.empty() && line[0] == 'p')
+        {
+            std::string str = line.substr(1);
+            size_t space_pos = str.find(' ');
+            if (space_pos != std::string::npos)
+            {
+                start_x = std::stoi(str.substr(0, space_pos));
+                start_y = std::stoi(str.substr(space_pos + 1));
+            }
+            break;
+        }
+
+        rows.push_back(line);
+        if (line.length() > width)
+        {
+            width = line.length();
+        }
+    }
+
+    // Ensure all lines have same width
+    for (auto& row : rows)
+    {
+        row.resize(width, '.');
+    }
+}
+
+void write_map(std::ostream& out, const Level& level, const State& state)
+{
+    // The format has no block-on-target tile; such a cell keeps its target
+    static const char TILE_CHARS[] = {'.', '#', 'B', 'T', 'T'};
+    for (int y = 0; y < level.height; ++y)
+    {
+        std::string row(level.width, '.');
+        for (int x = 0; x < level.width; ++x)
+        {
+            row[x] = TILE_CHARS[tile_at(level, state, x, y)];
+        }
+        out << row << '\n';
+    }
+    out << 'p' << state.px << ' ' << state.py << '\n';
+}
+
+bool load_level(const std::string& filename, Level& level, State& state)
+{
+    std::ifstream in(filename.c_str());
+    if (!in.is_open()) return false;
+
+    std::vector<std::string> rows;
+    int start_x = 1, start_y = 1;
+    read_map(in, rows, start_x, start_y);
+    build_level(rows, start_x, start_y, level, state);
+    return true;
+}
+
+void build_level(const std::vector<std::string>& rows, int start_x, int start_y,
+                 Level& level, State& state)
+{
+    level.width = 0;
+    for (const auto& row : rows)
+    {
+        if ((int)row.size() > level.width) level.width = row.size();
+    }
+    level.height = rows.size();
+    level.words = (level.width * level.height + WORD_BITS - 1) / WORD_BITS;
+    level.walls.assign(level.words, 0);
+    level.targets.assign(level.words, 0);
+    level.start_x = start_x;
+    level.start_y = start_y;
+
+    state.blocks.assign(level.words, 0);
+    state.px = start_x;
+    state.py = start_y;
+    state.holding_block = false;
+    state.moves = 0;
+
+    for (int y = 0; y < level.height; ++y)
+    {
+        for (int x = 0; x < (int)rows[y].size(); ++x)
+        {
+            int cell = cell_index(level, x, y);
+            char c = rows[y][x];
+
+            if (c == '#') flip_bit(level.walls, cell);
+            else if (c == 'B') flip_bit(state.blocks, cell);
+            else if (c == 'T') flip_bit(level.targets, cell);
+        }
+    }
+
+    state.unfilled_targets = 0;
+    for (int i = 0; i < level.words; ++i)
+    {
+        state.unfilled_targets += popcount(level.targets[i] & ~state.blocks[i]);
+    }
+}
+
+Tile tile_at(const Level& level, const State& state, int x, int y)
+{
+    int cell = cell_index(level, x, y);
+    if (test_bit(level.walls, cell)) return WALL;
+
+    bool block = test_bit(state.blocks, cell);
+    if (test_bit(level.targets, cell)) return block ? FILLED_TARGET : TARGET;
+    return block ? BLOCK : EMPTY;
+}
+
+// FNV-1a over the words of each plane
+static void hash_words(uint64_t& h, const std::vector<Word>& words)
+{
+    for (Word w : words)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            h ^= (w >> (i * 8)) & 0xff;
+            h *= 0x100000001b3ULL;
+        }
+    }
+}
+
+uint64_t level_hash(const Level& level, const State& start)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    std::vector<Word> header = {(Word)level.width, (Word)level.height,
+                                (Word)start.px, (Word)start.py, (Word)start.holding_block};
+    hash_words(h, header);
+    hash_words(h, level.walls);
+    hash_words(h, level.targets);
+    hash_words(h, start.blocks);
+    return h;
+}
+
+uint64_t layout_hash(const Level& level)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    std::vector<Word> header = {(Word)level.width, (Word)level.height};
+    hash_words(h, header);
+    hash_words(h, level.walls);
+    hash_words(h, level.targets);
+    return h;
+}
+
+bool apply_action(const Level& level, State& state, char action)
+{
+    int dx = 0, dy = 0;
+    if (action == 'h') dx = -1;
+    else if (action == 'l') dx = 1;
+    else if (action == 'j') dy = 1;
+    else if (action == 'k') dy = -1;
+
+    if (dx != 0 || dy != 0)
+    {
+        int nx = state.px + dx;
+        int ny = state.py + dy;
+        if (!in_bounds(level, nx, ny) || tile_at(level, state, nx, ny) == WALL) return false;
+        state.px = nx;
+        state.py = ny;
+    }
+    else
+    {
+        // Cut needs a block under the player, paste needs a free cell
+        Tile t = tile_at(level, state, state.px, state.py);
+        if (action == 'x' || action == 'd')
+        {
+            if (state.holding_block || (t != BLOCK && t != FILLED_TARGET)) return false;
+            state.holding_block = true;
+        }
+        else if (action == 'p')
+        {
+            if (!state.holding_block || (t != EMPTY && t != TARGET)) return false;
+            state.holding_block = false;
+        }
+        else
+        {
+            return false;
+        }
+        toggle_block(level, state, cell_index(level, state.px, state.py));
+    }
+
+    return true;
+}
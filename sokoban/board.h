@@ -0,0 +1,110 @@
+/*
+ * Sokoban - Board Representation
+ *
+ * A map is kept as flat bit planes indexed by cell = y * width + x.
+ * Walls and targets never change during a level, so they live in the
+ * Level once; a State only carries the block plane and the player.
+ */
+
+#ifndef SOKOBAN_BOARD_H
+#define SOKOBAN_BOARD_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum Tile
+{
+    EMPTY = 0,
+    WALL = 1,
+    BLOCK = 2,
+    TARGET = 3,
+    FILLED_TARGET = 4
+};
+
+typedef uint64_t Word;
+const int WORD_BITS = 64;
+
+struct Level
+{
+    int width, height;
+    int words; // Words per bit plane
+    std::vector<Word> walls;
+    std::vector<Word> targets;
+    int start_x, start_y;
+};
+
+struct State
+{
+    std::vector<Word> blocks;
+    int px, py;
+    bool holding_block;
+    int moves;
+    int unfilled_targets;
+};
+
+inline bool test_bit(const std::vector<Word>& plane, int cell)
+{
+    return (plane[cell / WORD_BITS] >> (cell % WORD_BITS)) & 1;
+}
+
+inline void flip_bit(std::vector<Word>& plane, int cell)
+{
+    plane[cell / WORD_BITS] ^= Word(1) << (cell % WORD_BITS);
+}
+
+inline int popcount(Word w)
+{
+    return __builtin_popcountll(w);
+}
+
+// Pick up or drop a block, keeping the unfilled target count in step
+inline void toggle_block(const Level& level, State& state, int cell)
+{
+    flip_bit(state.blocks, cell);
+    if (test_bit(level.targets, cell))
+    {
+        state.unfilled_targets += test_bit(state.blocks, cell) ? -1 : 1;
+    }
+}
+
+inline int cell_index(const Level& level, int x, int y)
+{
+    return y * level.width + x;
+}
+
+inline bool in_bounds(const Level& level, int x, int y)
+{
+    return x >= 0 && x < level.width && y >= 0 && y < level.height;
+}
+
+// Read map rows up to the 'p<x> <y>' line, padding them to equal width with
+// '.'; start_x/start_y are left alone when the file has no 'p' line
+void read_map(std::istream& in, std::vector<std::string>& rows, int& start_x, int& start_y);
+
+// Write a level in the format read_map() reads, 'p<x> <y>' line included
+void write_map(std::ostream& out, const Level& level, const State& state);
+
+// Read and build a map file without touching the game globals
+bool load_level(const std::string& filename, Level& level, State& state);
+
+// Build the level planes and the starting state from map rows ('#', 'B', 'T')
+void build_level(const std::vector<std::string>& rows, int start_x, int start_y,
+                 Level& level, State& state);
+
+Tile tile_at(const Level& level, const State& state, int x, int y);
+
+// Fingerprint of a puzzle: its size, walls, targets and starting state.
+// Stable across runs, so it can key files on disk.
+uint64_t level_hash(const Level& level, const State& start);
+
+// Fingerprint of the fixed part of a level only: size, walls and targets
+uint64_t layout_hash(const Level& level);
+
+// Apply one of h j k l x p with the game's rules; false (and the state left
+// untouched) when the action does nothing, which costs no move
+bool apply_action(const Level& level, State& state, char action);
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * Sokoban - Dead Squares
+ */
+
+#include "deadlock.h"
+
+void find_dead_squares(const Level& level, const State& start, DeadSquares& dead)
+{
+    static const int DIR_X[4] = {-1, 0, 0, 1};
+    static const int DIR_Y[4] = {0, 1, -1, 0};
+
+    dead.live.assign(level.words, 0);
+    std::vector<int> queue;
+    queue.push_back(cell_index(level, start.px, start.py));
+    flip_bit(dead.live, queue[0]); // Even when the level starts the player on a wall
+
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        int cell = queue[head];
+        int x = cell % level.width, y = cell / level.width;
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = x + DIR_X[d], ny = y + DIR_Y[d];
+            if (!in_bounds(level, nx, ny)) continue;
+
+            int next = cell_index(level, nx, ny);
+            if (test_bit(dead.live, next) || test_bit(level.walls, next)) continue;
+            flip_bit(dead.live, next);
+            queue.push_back(next);
+        }
+    }
+
+    dead.targets = 0;
+    dead.stranded_targets = 0;
+    for (int i = 0; i < level.words; ++i)
+    {
+        dead.targets += popcount(level.targets[i] & dead.live[i]);
+        dead.stranded_targets += popcount(level.targets[i] & ~dead.live[i] & ~start.blocks[i]);
+    }
+}
+
+int usable_blocks(const DeadSquares& dead, const State& state)
+{
+    int usable = state.holding_block ? 1 : 0;
+    for (size_t i = 0; i < dead.live.size(); ++i)
+    {
+        usable += popcount(state.blocks[i] & dead.live[i]);
+    }
+    return usable;
+}
+
+bool is_deadlocked(const DeadSquares& dead, const State& state)
+{
+    return dead.stranded_targets > 0 || usable_blocks(dead, state) < dead.targets;
+}
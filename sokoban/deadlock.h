@@ -0,0 +1,39 @@
+/*
+ * Sokoban - Dead Squares
+ *
+ * In this variant a block is never pushed: the player cuts it with x/d and
+ * may paste it on any free cell they can walk to, and can cut it again
+ * from there. So the only cells a block is lost on are the ones the player
+ * can never reach, and they are found once per level with one flood fill.
+ * A block pasted on reachable floor can always be picked up again, so no
+ * move changes the verdict and the game checks once, at level load.
+ */
+
+#ifndef SOKOBAN_DEADLOCK_H
+#define SOKOBAN_DEADLOCK_H
+
+#include "board.h"
+#include <vector>
+
+struct DeadSquares
+{
+    std::vector<Word> live; // Cells the player can reach from the start
+    int targets;            // Targets on live cells
+    int stranded_targets;   // Targets the player can never reach
+};
+
+void find_dead_squares(const Level& level, const State& start, DeadSquares& dead);
+
+inline bool is_dead_square(const DeadSquares& dead, int cell)
+{
+    return !test_bit(dead.live, cell);
+}
+
+// Blocks the player can still use: held, or lying on live cells
+int usable_blocks(const DeadSquares& dead, const State& state);
+
+// True when the state can no longer be won, because a target is out of
+// reach or there are fewer usable blocks than reachable targets
+bool is_deadlocked(const DeadSquares& dead, const State& state);
+
+#endif
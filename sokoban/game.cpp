@@ -6,33 +6,83 @@
 #include "game.h"
 #include "renderer.h"
 #include "globals.h"
+#include "board.h"
+#include "hint.h"
+#include "par.h"
+#include "solver.h"
+#include "solution.h"
+#include "undo_tree.h"
+#include "autowalk.h"
+#include "deadlock.h"
+#include "common/levelpack.h"
+#include <algorithm>
 #include <vector>
 #include <string>
-#include <stack>
 #include <cstdlib>
-#include <fstream>
 #include <sstream>
 #include <unistd.h>
 
-enum Tile
+LevelPack levels;
+Level current_level;
+State current_state;
+UndoTree history;
+
+// First key of a two-key command such as g- or fb, or 0
+int PENDING_KEY = 0;
+// Count typed before a command, as in 5l; 0 when none was typed
+int COUNT = 0;
+
+// How long the player has to stop typing before the hint search starts
+const int IDLE_TIMEOUT_MS = 300;
+bool SHOW_HINT = false;
+
+// The part of the map on screen, in cells. Maps larger than the terminal
+// scroll to keep the player in view.
+struct Camera
 {
-    EMPTY = 0,
-    WALL = 1,
-    BLOCK = 2,
-    TARGET = 3,
-    FILLED_TARGET = 4
+    int x, y;          // Top-left visible cell
+    int width, height; // Visible cells
 };
 
-struct State
+Camera camera = {0, 0, 0, 0};
+
+// Rows under the map for the UI panel and the border
+const int PANEL_ROWS = 16;
+// Columns left of the minimap in the UI panel
+const int MINIMAP_X = 42;
+
+// What draw_game() last put on screen
+struct Frame
 {
-    std::vector<std::vector<Tile>> map;
+    bool valid;
+    std::vector<Word> blocks;
     int px, py;
-    bool holding_block;
-    int moves;
+    Camera camera;
+    std::string ui[4]; // UI panel lines
 };
 
-State current_state;
-std::stack<State> history;
+Frame screen = {false, {}, 0, 0, {0, 0, 0, 0}, {}};
+
+// What draw_minimap() last drew: the rank of every square of scale x scale
+// cells, and the blocks, player and view they were drawn for. Rebuilt
+// whenever the screen is.
+struct Minimap
+{
+    int scale, cols, rows;
+    std::vector<char> rank;
+    std::vector<Word> blocks;
+    int px, py;
+    Camera camera;
+};
+
+Minimap minimap = {1, 0, 0, {}, {}, 0, 0, {0, 0, 0, 0}};
+
+// Cells no block can be used from, found when the level loads
+DeadSquares dead_squares;
+bool DEADLOCKED = false;
+
+// level_hash() of the level being played, for its par score
+uint64_t LEVEL_KEY = 0;
 
 // Player starting position from map file
 int START_X = 1;
@@ -44,10 +94,12 @@ void reset_globals()
     LEVEL_COMPLETE = false;
 }
 
-void load_map(const char* filename)
+void load_map(int level)
 {
-    std::ifstream in(filename);
-    if (!in.is_open())
+    std::istringstream in(levels.text(level));
+    GAME_BOARD.clear();
+    read_map(in, GAME_BOARD, START_X, START_Y);
+    if (GAME_BOARD.empty())
     {
         // Fallback to simple map
         MAP_WIDTH = 15;
@@ -55,321 +107,589 @@ void load_map(const char* filename)
         return;
     }
 
-    GAME_BOARD.clear();
-    std::string line;
-    MAP_WIDTH = 0;
-    MAP_HEIGHT = 0;
-
-    while (std::getline(in, line))
-    {
-        // Check for player position line (starts with 'p')
-        if (!line.empty() && line[0] == 'p')
-        {
-            std::string str = line.substr(1);
-            size_t space_pos = str.find(' ');
-            if (space_pos != std::string::npos)
-            {
-                START_X = std::stoi(str.substr(0, space_pos));
-                START_Y = std::stoi(str.substr(space_pos + 1));
-            }
-            break;
-        }
-
-        GAME_BOARD.push_back(line);
-        if (line.length() > MAP_WIDTH)
-        {
-            MAP_WIDTH = line.length();
-        }
-        MAP_HEIGHT++;
-    }
+    MAP_HEIGHT = GAME_BOARD.size();
+    MAP_WIDTH = GAME_BOARD[0].size();
+}
 
-    in.close();
+void init_game()
+{
+    // Load the map for current level
+    load_map(CURRENT_LEVEL);
 
-    // Ensure all lines have same width
-    for (auto& row : GAME_BOARD)
+    // Parse map from GAME_BOARD into the level planes and starting state
+    std::vector<std::string> rows(GAME_BOARD.begin(), GAME_BOARD.end());
+    rows.resize(MAP_HEIGHT);
+    for (auto& row : rows)
     {
         row.resize(MAP_WIDTH, '.');
     }
+    build_level(rows, START_X, START_Y, current_level, current_state);
+
+    // Solved in the background while the player gets going
+    LEVEL_KEY = level_hash(current_level, current_state);
+    par_request(current_level, current_state);
+
+    // Blocks are only cut from and pasted on cells the player stands on, so
+    // no move changes the usable block count: one check holds for the level
+    find_dead_squares(current_level, current_state, dead_squares);
+    DEADLOCKED = is_deadlocked(dead_squares, current_state);
+
+    // Clear history
+    undo_reset(history);
+    PENDING_KEY = 0;
+    COUNT = 0;
+    hint_reset();
+    screen.valid = false;
+    camera.x = 0;
+    camera.y = 0;
+
+    reset_globals();
 }
 
-void init_game()
+Delta begin_move()
 {
-    // Load the map for current level
-    std::string mapName = MAPS_LOCATION
-    "/map";
-    std::stringstream ss;
-    ss << CURRENT_LEVEL;
-    mapName += ss.str() + ".txt";
-
-    load_map(mapName.c_str());
+    Delta d;
+    d.dx = 0;
+    d.dy = 0;
+    d.was_holding = current_state.holding_block;
+    return d;
+}
 
-    // Initialize state
-    current_state.px = START_X;
-    current_state.py = START_Y;
-    current_state.holding_block = false;
-    current_state.moves = 0;
+Tile tile_at(int x, int y)
+{
+    return tile_at(current_level, current_state, x, y);
+}
 
-    // Parse map from GAME_BOARD
-    current_state.map.clear();
-    current_state.map.resize(MAP_HEIGHT);
+void save_move(const Delta& d, int moves)
+{
+    undo_record(history, d, moves);
+}
 
-    for (int y = 0; y < MAP_HEIGHT; ++y)
+// Move to another node of the undo tree; the move counters follow the
+// moves it takes to get there from the level start
+void jump_to(int node)
+{
+    if (undo_jump(history, current_level, current_state, node))
     {
-        current_state.map[y].resize(MAP_WIDTH);
-        for (int x = 0; x < MAP_WIDTH; ++x)
-        {
-            char c = (y < GAME_BOARD.size() && x < GAME_BOARD[y].size())
-                         ? GAME_BOARD[y][x]
-                         : '.';
-
-            if (c == '#') current_state.map[y][x] = WALL;
-            else if (c == 'B') current_state.map[y][x] = BLOCK;
-            else if (c == 'T') current_state.map[y][x] = TARGET;
-            else current_state.map[y][x] = EMPTY;
-        }
+        int depth = history.nodes[history.current].depth;
+        TOTAL_MOVES += depth - LEVEL_MOVES;
+        LEVEL_MOVES = depth;
     }
+}
 
-    // Clear history
-    while (!history.empty()) history.pop();
-    history.push(current_state);
+void undo()
+{
+    jump_to(history.nodes[history.current].parent);
+}
 
-    reset_globals();
+void redo()
+{
+    jump_to(history.nodes[history.current].redo_child);
 }
 
-void save_state()
+bool check_win()
 {
-    history.push(current_state);
+    // Holding a block means it still needs placement
+    return current_state.unfilled_targets == 0 && !current_state.holding_block;
 }
 
-void undo()
+// Apply actions (h j k l x p) up to the first that does nothing, as one
+// history entry: one undo step however many moves it took
+void run_batch(const std::string& actions)
 {
-    if (history.size() > 1)
+    Delta d = begin_move();
+    int px = current_state.px, py = current_state.py;
+    int moves = 0;
+    for (char action : actions)
     {
-        history.pop();
-        current_state = history.top();
-        if (LEVEL_MOVES > 0) LEVEL_MOVES--;
-        if (TOTAL_MOVES > 0) TOTAL_MOVES--;
+        int cell = cell_index(current_level, current_state.px, current_state.py);
+        bool was_holding = current_state.holding_block;
+        if (!apply_action(current_level, current_state, action)) break;
+
+        if (current_state.holding_block != was_holding) d.flipped.push_back(cell);
+        d.actions += action == 'd' ? 'x' : action;
+        moves++;
     }
+    if (moves == 0) return;
+
+    d.dx = current_state.px - px;
+    d.dy = current_state.py - py;
+    save_move(d, moves);
+    LEVEL_MOVES += moves;
+    TOTAL_MOVES += moves;
 }
 
-bool check_win()
+// Does the tile match a jump target: b block, t empty target, f filled one
+bool tile_matches(Tile t, int c)
+{
+    return (c == 'b' && t == BLOCK) || (c == 't' && t == TARGET) || (c == 'f' && t == FILLED_TARGET);
+}
+
+// Steps for f/F/t/T<tile>: along the row to the count-th matching tile, or
+// one short of it for t/T; empty when a wall comes first
+std::string find_in_row(int motion, int c, int count)
 {
-    for (int y = 0; y < MAP_HEIGHT; ++y)
+    int dir = (motion == 'f' || motion == 't') ? 1 : -1;
+    int x = current_state.px;
+    while (count > 0)
     {
-        for (int x = 0; x < MAP_WIDTH; ++x)
-        {
-            if (current_state.map[y][x] == TARGET)
-            {
-                return false; // Empty target found
-            }
-        }
+        x += dir;
+        if (x < 0 || x >= MAP_WIDTH || tile_at(x, current_state.py) == WALL) return "";
+        if (tile_matches(tile_at(x, current_state.py), c)) count--;
     }
-    // Check if holding a block that needs placement
-    if (current_state.holding_block)
+    if (motion == 't' || motion == 'T') x -= dir;
+
+    int steps = std::abs(x - current_state.px);
+    return std::string(steps, dir > 0 ? 'l' : 'h');
+}
+
+// Steps for 0 and $: to the end of the open stretch of the row
+std::string row_end(int dir)
+{
+    int x = current_state.px;
+    while (x + dir >= 0 && x + dir < MAP_WIDTH && tile_at(x + dir, current_state.py) != WALL)
     {
-        return false;
+        x += dir;
     }
-    return true;
+    return std::string(std::abs(x - current_state.px), dir > 0 ? 'l' : 'h');
 }
 
 void update_input(int ch)
 {
-    int dx = 0, dy = 0;
-    bool moved = false;
-
     if (ch == 'q')
     {
         close_renderer();
         exit(0);
     }
 
+    if (ch == 27) // Esc drops a half-typed command
+    {
+        PENDING_KEY = 0;
+        COUNT = 0;
+        return;
+    }
+
+    // Count prefix; a leading 0 is the motion, not a digit
+    if (ch >= '0' && ch <= '9' && (ch != '0' || COUNT > 0) && !PENDING_KEY)
+    {
+        COUNT = std::min(COUNT * 10 + (ch - '0'), 9999);
+        return;
+    }
+
+    int count = std::max(COUNT, 1);
+    int pending = PENDING_KEY;
+    COUNT = 0;
+    PENDING_KEY = 0;
+
+    if (pending == 'g')
+    {
+        // g- and g+ step through states in the order they were reached,
+        // crossing branches
+        if (ch == '-') jump_to(history.current - count);
+        else if (ch == '+') jump_to(history.current + count);
+
+        // gb and gt walk to the nearest loose block or empty target
+        else if (ch == 'b' || ch == 't') run_batch(walk_to_nearest(current_level, current_state, ch));
+        return;
+    }
+
+    if (pending == 'f' || pending == 'F' || pending == 't' || pending == 'T')
+    {
+        run_batch(find_in_row(pending, ch, count));
+        return;
+    }
+
+    if (ch == 'g' || ch == 'f' || ch == 'F' || ch == 't' || ch == 'T')
+    {
+        // Wait for the second key, keeping the count for it
+        PENDING_KEY = ch;
+        COUNT = count > 1 ? count : 0;
+        return;
+    }
+
     if (ch == 'u')
     {
-        undo();
+        for (int i = 0; i < count; ++i) undo();
         return;
     }
 
-    // Movement
-    if (ch == 'h')
+    if (ch == 18) // Ctrl-R
+    {
+        for (int i = 0; i < count; ++i) redo();
+        return;
+    }
+
+    if (ch == '?')
+    {
+        // Show or hide the next optimal action; ask for it right away
+        SHOW_HINT = !SHOW_HINT;
+        if (SHOW_HINT) hint_request(current_level, current_state);
+        return;
+    }
+
+    if (ch == '0')
+    {
+        run_batch(row_end(-1));
+        return;
+    }
+
+    if (ch == '$')
+    {
+        run_batch(row_end(1));
+        return;
+    }
+
+    // Movement (hjkl), repeated count times, and vim actions: x/d cut the
+    // block under the player, p pastes it back
+    if (ch == 'h' || ch == 'j' || ch == 'k' || ch == 'l')
+    {
+        run_batch(std::string(count, ch));
+    }
+    else if (ch == 'x' || ch == 'd' || ch == 'p')
+    {
+        run_batch(std::string(1, ch));
+    }
+}
+
+void draw_tile(int x, int y)
+{
+    Tile t = tile_at(x, y);
+    std::string s = "  ";
+    int color = 7; // White default
+
+    if (t == WALL)
     {
-        dx = -1;
-        moved = true;
+        s = "🧱";
+        color = 3; // Yellow
     }
-    else if (ch == 'l')
+    else if (t == BLOCK)
     {
-        dx = 1;
-        moved = true;
+        s = "📦";
+        color = 6; // Cyan
     }
-    else if (ch == 'j')
+    else if (t == TARGET)
     {
-        dy = 1;
-        moved = true;
+        s = "⭕";
+        color = 1; // Red
     }
-    else if (ch == 'k')
+    else if (t == FILLED_TARGET)
     {
-        dy = -1;
-        moved = true;
+        s = "✅";
+        color = 2; // Green
     }
 
-    // Vim Actions
-    else if (ch == 'x' || ch == 'd')
+    // Draw player on top
+    if (x == current_state.px && y == current_state.py)
     {
-        // Cut/Delete block under player
-        if (!current_state.holding_block)
+        s = "🧙";
+        color = 5; // Magenta
+    }
+
+    draw_entity_colored(x - camera.x, y - camera.y, s, color);
+}
+
+bool in_view(int x, int y)
+{
+    return x >= camera.x && x < camera.x + camera.width &&
+           y >= camera.y && y < camera.y + camera.height;
+}
+
+// Scroll one axis so pos stays a quarter of the view away from its edges
+void follow(int& cam, int view, int pos, int size)
+{
+    int margin = view / 4;
+    if (pos < cam + margin) cam = pos - margin;
+    if (pos >= cam + view - margin) cam = pos - view + margin + 1;
+    cam = std::max(0, std::min(cam, size - view));
+}
+
+// Fit the view to the terminal and move it after the player
+void update_camera()
+{
+    int rows, cols;
+    get_screen_size(rows, cols);
+    camera.width = std::max(1, std::min(MAP_WIDTH, (cols - OFFSET_X * 2) / 2));
+    camera.height = std::max(1, std::min(MAP_HEIGHT, rows - OFFSET_Y - PANEL_ROWS));
+    follow(camera.x, camera.width, current_state.px, MAP_WIDTH);
+    follow(camera.y, camera.height, current_state.py, MAP_HEIGHT);
+}
+
+void draw_game_board()
+{
+    bool scrolled = screen.camera.x != camera.x || screen.camera.y != camera.y;
+    if (!screen.valid || scrolled)
+    {
+        // Draw the visible part of the map
+        for (int y = camera.y; y < camera.y + camera.height; ++y)
         {
-            Tile t = current_state.map[current_state.py][current_state.px];
-            if (t == BLOCK || t == FILLED_TARGET)
+            for (int x = camera.x; x < camera.x + camera.width; ++x)
             {
-                save_state();
-                current_state.holding_block = true;
-                if (t == FILLED_TARGET)
-                {
-                    current_state.map[current_state.py][current_state.px] = TARGET;
-                }
-                else
-                {
-                    current_state.map[current_state.py][current_state.px] = EMPTY;
-                }
-                LEVEL_MOVES++;
-                TOTAL_MOVES++;
+                draw_tile(x, y);
             }
         }
     }
-    else if (ch == 'p')
+    else
     {
-        // Paste/Put block
-        if (current_state.holding_block)
+        // Only cells whose block bit flipped since the last frame, found a
+        // word at a time, plus where the player was and is
+        for (int i = 0; i < current_level.words; ++i)
         {
-            Tile t = current_state.map[current_state.py][current_state.px];
-            if (t == EMPTY || t == TARGET)
+            for (Word w = current_state.blocks[i] ^ screen.blocks[i]; w; w &= w - 1)
             {
-                save_state();
-                current_state.holding_block = false;
-                if (t == TARGET)
-                {
-                    current_state.map[current_state.py][current_state.px] = FILLED_TARGET;
-                }
-                else
-                {
-                    current_state.map[current_state.py][current_state.px] = BLOCK;
-                }
-                LEVEL_MOVES++;
-                TOTAL_MOVES++;
+                int cell = i * WORD_BITS + __builtin_ctzll(w);
+                int x = cell % MAP_WIDTH, y = cell / MAP_WIDTH;
+                if (in_view(x, y)) draw_tile(x, y);
             }
         }
+        if (screen.px != current_state.px || screen.py != current_state.py)
+        {
+            draw_tile(screen.px, screen.py);
+            draw_tile(current_state.px, current_state.py);
+        }
     }
 
-    // Apply movement
-    if (moved && (dx != 0 || dy != 0))
-    {
-        int nx = current_state.px + dx;
-        int ny = current_state.py + dy;
+    screen.blocks = current_state.blocks;
+    screen.px = current_state.px;
+    screen.py = current_state.py;
+    screen.camera = camera;
+}
 
-        // Check bounds
-        if (nx >= 0 && nx < MAP_WIDTH && ny >= 0 && ny < MAP_HEIGHT)
+// The most important thing in a minimap square: 1 wall, 2 floor, 3 filled
+// target, 4 block, 5 empty target, 6 player
+int minimap_rank(int mx, int my)
+{
+    int scale = minimap.scale;
+    int rank = 0;
+    for (int y = my * scale; y < std::min(MAP_HEIGHT, (my + 1) * scale); ++y)
+    {
+        for (int x = mx * scale; x < std::min(MAP_WIDTH, (mx + 1) * scale); ++x)
         {
-            // Check walls
-            if (current_state.map[ny][nx] != WALL)
-            {
-                save_state();
-                current_state.px = nx;
-                current_state.py = ny;
-                LEVEL_MOVES++;
-                TOTAL_MOVES++;
-            }
+            Tile t = tile_at(x, y);
+            int r = t == WALL ? 1 : t == EMPTY ? 2 : t == FILLED_TARGET ? 3 : t == BLOCK ? 4 : 5;
+            if (x == current_state.px && y == current_state.py) r = 6;
+            rank = std::max(rank, r);
         }
     }
+    return rank;
 }
 
-void draw_game_board()
+void draw_minimap_square(int left, int top, int mx, int my)
+{
+    int scale = minimap.scale;
+    bool visible = mx * scale < camera.x + camera.width && (mx + 1) * scale > camera.x &&
+                   my * scale < camera.y + camera.height && (my + 1) * scale > camera.y;
+    int rank = minimap.rank[my * minimap.cols + mx];
+
+    static const char GLYPHS[] = " #.*b+@";
+    static const int COLORS[] = {7, 3, 7, 2, 6, 1, 5};
+    int color = rank <= 2 && !visible ? 4 : COLORS[rank];
+    draw_text_colored(left + mx, top + 1 + my, std::string(1, GLYPHS[rank]), color);
+}
+
+// Work out a cell's square again after the cell changed, and redraw it
+void update_minimap_cell(int left, int top, int x, int y)
+{
+    int mx = x / minimap.scale, my = y / minimap.scale;
+    minimap.rank[my * minimap.cols + mx] = minimap_rank(mx, my);
+    draw_minimap_square(left, top, mx, my);
+}
+
+// The whole level at reduced resolution, one character per square of
+// cells, in the UI panel right of the instructions. Only shown when the
+// map does not fit on screen; the visible part is drawn brighter. Squares
+// are ranked once per level and then only where blocks or the player moved.
+void draw_minimap()
 {
-    // Draw Map
-    for (int y = 0; y < MAP_HEIGHT; ++y)
+    if (camera.width == MAP_WIDTH && camera.height == MAP_HEIGHT) return;
+
+    int top = camera.height + OFFSET_Y + 1;
+    int left = OFFSET_X + MINIMAP_X;
+    int avail_w = camera.width * 2 - MINIMAP_X;
+    int avail_h = PANEL_ROWS - 4; // Title row, then the map
+    if (avail_w < 8) return;
+
+    if (!screen.valid)
     {
-        for (int x = 0; x < MAP_WIDTH; ++x)
+        int scale = 1;
+        while ((MAP_WIDTH + scale - 1) / scale > avail_w || (MAP_HEIGHT + scale - 1) / scale > avail_h)
         {
-            Tile t = current_state.map[y][x];
-            std::string s = "  ";
-            int color = 7; // White default
+            scale++;
+        }
 
-            if (t == WALL)
-            {
-                s = "🧱";
-                color = 3; // Yellow
-            }
-            else if (t == BLOCK)
-            {
-                s = "📦";
-                color = 6; // Cyan
-            }
-            else if (t == TARGET)
+        std::stringstream ss;
+        ss << "Map 1:" << scale;
+        draw_text(left, top, ss.str());
+
+        minimap.scale = scale;
+        minimap.cols = (MAP_WIDTH + scale - 1) / scale;
+        minimap.rows = (MAP_HEIGHT + scale - 1) / scale;
+        minimap.rank.assign(minimap.cols * minimap.rows, 0);
+        for (int my = 0; my < minimap.rows; ++my)
+        {
+            for (int mx = 0; mx < minimap.cols; ++mx)
             {
-                s = "⭕";
-                color = 1; // Red
+                minimap.rank[my * minimap.cols + mx] = minimap_rank(mx, my);
+                draw_minimap_square(left, top, mx, my);
             }
-            else if (t == FILLED_TARGET)
+        }
+    }
+    else
+    {
+        // Same block word XOR as draw_game_board()
+        for (int i = 0; i < current_level.words; ++i)
+        {
+            for (Word w = current_state.blocks[i] ^ minimap.blocks[i]; w; w &= w - 1)
             {
-                s = "✅";
-                color = 2; // Green
+                int cell = i * WORD_BITS + __builtin_ctzll(w);
+                update_minimap_cell(left, top, cell % MAP_WIDTH, cell / MAP_WIDTH);
             }
+        }
+        if (minimap.px != current_state.px || minimap.py != current_state.py)
+        {
+            update_minimap_cell(left, top, minimap.px, minimap.py);
+            update_minimap_cell(left, top, current_state.px, current_state.py);
+        }
 
-            // Draw player on top
-            if (x == current_state.px && y == current_state.py)
+        // Scrolling moves the brighter part
+        if (minimap.camera.x != camera.x || minimap.camera.y != camera.y)
+        {
+            for (int my = 0; my < minimap.rows; ++my)
             {
-                s = "🧙";
-                color = 5; // Magenta
+                for (int mx = 0; mx < minimap.cols; ++mx)
+                {
+                    draw_minimap_square(left, top, mx, my);
+                }
             }
-
-            draw_entity_colored(x, y, s, color);
         }
     }
+
+    minimap.blocks = current_state.blocks;
+    minimap.px = current_state.px;
+    minimap.py = current_state.py;
+    minimap.camera = camera;
 }
 
-void draw_ui()
+// Terminal columns taken by a UI string: emoji (four UTF-8 bytes) are two
+// columns wide, any other character one
+int display_width(const std::string& text)
 {
-    int uiBaseY = MAP_HEIGHT + OFFSET_Y + 1;
+    int width = 0;
+    for (unsigned char c : text)
+    {
+        if ((c & 0xC0) == 0x80) continue;
+        width += c >= 0xF0 ? 2 : 1;
+    }
+    return width;
+}
+
+// Draw one line of the UI panel if its text changed, blanking what is left
+// of the old one; color 0 is the terminal default
+void draw_ui_line(int row, const std::string& text, int color = 0)
+{
+    int uiBaseY = camera.height + OFFSET_Y + 1;
     int uiBaseX = OFFSET_X;
 
+    if (screen.valid && screen.ui[row] == text) return;
+
+    std::string padded = text;
+    if (screen.valid)
+    {
+        int blank = display_width(screen.ui[row]) - display_width(text);
+        if (blank > 0) padded.append(blank, ' ');
+    }
+    if (color) draw_text_colored(uiBaseX, uiBaseY + row, padded, color);
+    else draw_text(uiBaseX, uiBaseY + row, padded);
+    screen.ui[row] = text;
+}
+
+std::string hint_text()
+{
+    switch (hint_lookup(state_hash(current_level, current_state)))
+    {
+    case 'h': return "h (left)";
+    case 'j': return "j (down)";
+    case 'k': return "k (up)";
+    case 'l': return "l (right)";
+    case 'x': return "x (pick up)";
+    case 'p': return "p (place)";
+    case HINT_STUCK: return "no solution from here, try [u]";
+    default: return hint_busy() ? "thinking..." : "...";
+    }
+}
+
+void draw_ui()
+{
     // Stats
     std::stringstream ss;
     ss << "Level: " << (CURRENT_LEVEL + 1) << "/" << NUM_OF_LEVELS;
-    draw_text(uiBaseX, uiBaseY, ss.str());
+    draw_ui_line(0, ss.str());
 
     ss.str("");
     ss << "Moves: " << LEVEL_MOVES << " (Total: " << TOTAL_MOVES << ")";
-    draw_text(uiBaseX, uiBaseY + 1, ss.str());
+    draw_ui_line(1, ss.str());
 
     ss.str("");
     ss << "Held: " << (current_state.holding_block ? "📦 Box" : "Nothing");
-    draw_text(uiBaseX, uiBaseY + 2, ss.str());
+    draw_ui_line(2, ss.str());
+
+    if (DEADLOCKED)
+    {
+        draw_ui_line(3, dead_squares.stranded_targets > 0 ? "⚠ Unsolvable: unreachable target"
+                                                           : "⚠ Unsolvable: too few boxes", 1);
+    }
+    else
+    {
+        draw_ui_line(3, SHOW_HINT ? "Hint: " + hint_text() : "", 3);
+    }
+}
+
+// The parts of the screen that never change during a level
+void draw_frame()
+{
+    clear_screen();
+
+    // Draw border
+    int totalWidth = (camera.width * 2) + (OFFSET_X * 2);
+    int totalHeight = camera.height + OFFSET_Y + PANEL_ROWS;
+    draw_box(totalWidth, totalHeight);
+
+    int uiBaseY = camera.height + OFFSET_Y + 1;
+    int uiBaseX = OFFSET_X;
 
     // Vim keys diagram
     draw_vim_keys(uiBaseY + 4, uiBaseX);
 
     // Instructions
     draw_text(uiBaseX, uiBaseY + 9, "[x/d] Pick Box  [p] Place Box  [u] Undo");
-    draw_text(uiBaseX, uiBaseY + 10, "[q] Quit");
+    draw_text(uiBaseX, uiBaseY + 10, "[Ctrl-R] Redo  [g-/g+] Older/Newer");
+    draw_text(uiBaseX, uiBaseY + 11, "[5l] Count  [fb/ft] Jump  [0/$] Row");
+    draw_text(uiBaseX, uiBaseY + 12, "[gb/gt] Walk  [?] Hint  [q] Quit");
 }
 
 void draw_game()
 {
-    clear_screen();
-
-    // Draw border
-    int totalWidth = (MAP_WIDTH * 2) + (OFFSET_X * 2);
-    int totalHeight = MAP_HEIGHT + OFFSET_Y + 16;
-    draw_box(totalWidth, totalHeight);
+    // Repaint only what changed since the last frame; ncurses then sends
+    // just those cells instead of a full screen of emoji
+    update_camera();
+    if (camera.width != screen.camera.width || camera.height != screen.camera.height)
+    {
+        screen.valid = false; // Terminal resized
+    }
 
+    if (!screen.valid) draw_frame();
     draw_game_board();
     draw_ui();
+    draw_minimap();
+    screen.valid = true;
 
     // Victory message
     if (check_win())
     {
         LEVEL_COMPLETE = true;
-        int centerX = MAP_WIDTH;
-        int centerY = MAP_HEIGHT / 2;
+        int centerX = camera.width;
+        int centerY = camera.height / 2;
         draw_text_colored(centerX * 2, centerY + OFFSET_Y, "🎉 LEVEL COMPLETE! 🎉", 2);
+        screen.valid = false; // The message covers tiles
     }
 
     refresh_screen();
@@ -442,6 +762,14 @@ void welcome_screen()
     draw_text(12, y++, "   [x] or [d] - Delete/Cut box (pick it up)");
     draw_text(12, y++, "   [p]        - Paste box (place it down)");
     draw_text(12, y++, "   [u]        - Undo last move");
+    draw_text(12, y++, "   [Ctrl-R]   - Redo an undone move");
+    draw_text(12, y++, "   [g-] [g+]  - Older/newer state, across branches");
+    draw_text(12, y++, "   [5l]       - Counts repeat a move, as one undo step");
+    draw_text(12, y++, "   [fb] [ft]  - Jump along the row to a box/target");
+    draw_text(12, y++, "              (F backwards, t/T stop just before)");
+    draw_text(12, y++, "   [0] [$]    - Start/end of the row");
+    draw_text(12, y++, "   [gb] [gt]  - Walk to the nearest box/target");
+    draw_text(12, y++, "   [?]        - Show/hide a hint");
     draw_text(12, y++, "   [q]        - Quit game");
 
     y += 1;
@@ -544,21 +872,30 @@ void level_complete_screen()
         ss << "   • Total Moves So Far: " << TOTAL_MOVES;
         draw_text(18, y++, ss.str());
 
-        // Performance rating
+        // Performance rating: PERFECT at par, GREAT within 125% and GOOD
+        // within 150% of it; the old fixed cutoffs while par is unknown
+        int par = par_lookup(LEVEL_KEY);
+        if (par != PAR_UNKNOWN)
+        {
+            ss.str("");
+            ss << "   • Par: " << par << " (" << LEVEL_MOVES * 100 / par << "%)";
+            draw_text(18, y++, ss.str());
+        }
+
         y++;
         std::string rating;
         int rating_color = 2;
-        if (LEVEL_MOVES <= 10)
+        if (par != PAR_UNKNOWN ? LEVEL_MOVES <= par : LEVEL_MOVES <= 10)
         {
             rating = "⭐⭐⭐ PERFECT! ⭐⭐⭐";
             rating_color = 2;
         }
-        else if (LEVEL_MOVES <= 20)
+        else if (par != PAR_UNKNOWN ? LEVEL_MOVES * 4 <= par * 5 : LEVEL_MOVES <= 20)
         {
             rating = "⭐⭐ GREAT! ⭐⭐";
             rating_color = 3;
         }
-        else if (LEVEL_MOVES <= 40)
+        else if (par != PAR_UNKNOWN ? LEVEL_MOVES * 2 <= par * 3 : LEVEL_MOVES <= 40)
         {
             rating = "⭐ GOOD! ⭐";
             rating_color = 6;
@@ -642,6 +979,12 @@ int sokoban_main(int argc, char** argv)
 {
     init_renderer();
 
+    // The level count comes from the pack (or the map files) on disk
+    if (levels.load(MAPS_LOCATION))
+    {
+        NUM_OF_LEVELS = levels.count();
+    }
+
     // Parse command line arguments
     if (!check_params(argc, argv))
     {
@@ -658,12 +1001,28 @@ int sokoban_main(int argc, char** argv)
         level_message();
         init_game();
 
-        // Play current level
+        // Play current level. Input times out while the player is idle so
+        // the hint search can start and its answer be shown when it lands.
+        set_input_timeout(IDLE_TIMEOUT_MS);
+        std::string shown_hint;
+        bool redraw = true;
         while (!LEVEL_COMPLETE)
         {
-            draw_game();
+            if (redraw)
+            {
+                draw_game();
+                shown_hint = hint_text();
+            }
             int ch = get_input();
+            if (ch == NO_INPUT)
+            {
+                hint_request(current_level, current_state);
+                redraw = SHOW_HINT && hint_text() != shown_hint;
+                continue;
+            }
+            if (ch != '?') hint_cancel();
             update_input(ch);
+            redraw = true;
 
             if (check_win())
             {
@@ -673,6 +1032,10 @@ int sokoban_main(int argc, char** argv)
             }
         }
 
+        set_input_timeout(-1);
+        hint_cancel();
+        save_solution(levels.name(CURRENT_LEVEL), undo_path(history));
+
         // Show completion screen
         level_complete_screen();
     }
@@ -0,0 +1,230 @@
+/*
+ * Sokoban - Level Generator
+ *
+ * Carves random rooms joined by corridors, scatters blocks and targets on
+ * the floor and keeps the candidates whose optimal solution falls within
+ * the requested move band. Candidates are generated and solved on all
+ * cores; accepted levels are written easiest first as map<N>.txt in the
+ * format load_map() reads. The searches running at once share -B
+ * megabytes, half the physical memory by default.
+ *
+ * Usage: generate [-j threads] [-c count] [-W width] [-H height]
+ *                 [-b blocks] [-m min_moves] [-M max_moves] [-s seed]
+ *                 [-f first_index] [-o out_dir] [-B megabytes]
+ */
+
+#include "board.h"
+#include "solver.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+// Candidates that need more than this are too hard for the band anyway
+const long GENERATE_MAX_NODES = 200000;
+
+struct Options
+{
+    unsigned threads = 0;
+    int count = 10;
+    int width = 24;
+    int height = 10;
+    int blocks = 3;
+    int min_moves = 30;
+    int max_moves = 90;
+    unsigned seed = 1;
+    int first = 0;
+    long attempts = 200000; // Across all threads, so a bad band still ends
+    std::string out_dir = ".";
+    size_t max_bytes = batch_search_bytes();
+};
+
+struct Generated
+{
+    int moves;
+    std::vector<std::string> rows;
+    int start_x, start_y;
+};
+
+static void carve(std::vector<std::string>& rows, int x0, int y0, int x1, int y1)
+{
+    for (int y = std::min(y0, y1); y <= std::max(y0, y1); ++y)
+    {
+        for (int x = std::min(x0, x1); x <= std::max(x0, x1); ++x)
+        {
+            rows[y][x] = '.';
+        }
+    }
+}
+
+// Two to four rooms, each joined to the previous one by an L-shaped
+// corridor, so all the floor is connected
+static std::vector<std::string> make_rooms(const Options& opt, std::mt19937& rng)
+{
+    std::vector<std::string> rows(opt.height, std::string(opt.width, '#'));
+    auto pick = [&rng](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+    int rooms = pick(2, 4);
+    int prev_x = -1, prev_y = -1;
+    for (int i = 0; i < rooms; ++i)
+    {
+        int w = pick(3, std::max(3, opt.width / 2));
+        int h = pick(2, std::max(2, opt.height / 2));
+        int x = pick(1, opt.width - 1 - w);
+        int y = pick(1, opt.height - 1 - h);
+        carve(rows, x, y, x + w - 1, y + h - 1);
+
+        int cx = x + w / 2, cy = y + h / 2;
+        if (prev_x >= 0)
+        {
+            carve(rows, prev_x, prev_y, cx, prev_y);
+            carve(rows, cx, prev_y, cx, cy);
+        }
+        prev_x = cx;
+        prev_y = cy;
+    }
+    return rows;
+}
+
+// One candidate level, searched within worker_bytes; false when it is
+// unsolvable or outside the band
+static bool try_candidate(const Options& opt, size_t worker_bytes, std::mt19937& rng, Generated& out)
+{
+    std::vector<std::string> rows = make_rooms(opt, rng);
+
+    std::vector<std::pair<int, int>> floor;
+    for (int y = 0; y < opt.height; ++y)
+    {
+        for (int x = 0; x < opt.width; ++x)
+        {
+            if (rows[y][x] == '.') floor.push_back(std::make_pair(x, y));
+        }
+    }
+    if ((int)floor.size() < opt.blocks * 2 + 1) return false;
+
+    // Distinct cells for the start, the blocks and the targets
+    std::shuffle(floor.begin(), floor.end(), rng);
+    for (int i = 0; i < opt.blocks; ++i)
+    {
+        rows[floor[1 + i].second][floor[1 + i].first] = 'B';
+        rows[floor[1 + opt.blocks + i].second][floor[1 + opt.blocks + i].first] = 'T';
+    }
+
+    Level level;
+    State state;
+    build_level(rows, floor[0].first, floor[0].second, level, state);
+
+    SolveResult r = solve(level, state, std::min(GENERATE_MAX_NODES, node_budget(level, worker_bytes)));
+    if (!r.solved || r.moves < opt.min_moves || r.moves > opt.max_moves) return false;
+
+    out.moves = r.moves;
+    out.rows = rows;
+    out.start_x = floor[0].first;
+    out.start_y = floor[0].second;
+    return true;
+}
+
+static bool parse_args(int argc, char** argv, Options& opt)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc) return false;
+        const char* flag = argv[i];
+        const char* value = argv[++i];
+
+        if (strcmp(flag, "-j") == 0) opt.threads = atoi(value);
+        else if (strcmp(flag, "-c") == 0) opt.count = atoi(value);
+        else if (strcmp(flag, "-W") == 0) opt.width = atoi(value);
+        else if (strcmp(flag, "-H") == 0) opt.height = atoi(value);
+        else if (strcmp(flag, "-b") == 0) opt.blocks = atoi(value);
+        else if (strcmp(flag, "-m") == 0) opt.min_moves = atoi(value);
+        else if (strcmp(flag, "-M") == 0) opt.max_moves = atoi(value);
+        else if (strcmp(flag, "-s") == 0) opt.seed = strtoul(value, nullptr, 10);
+        else if (strcmp(flag, "-f") == 0) opt.first = atoi(value);
+        else if (strcmp(flag, "-o") == 0) opt.out_dir = value;
+        else if (strcmp(flag, "-B") == 0) opt.max_bytes = (size_t)atol(value) << 20;
+        else return false;
+    }
+    return opt.width >= 5 && opt.height >= 4 && opt.blocks > 0 && opt.count > 0 &&
+           opt.min_moves <= opt.max_moves;
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parse_args(argc, argv, opt))
+    {
+        fprintf(stderr, "Usage: %s [-j threads] [-c count] [-W width] [-H height]\n"
+                        "       [-b blocks] [-m min_moves] [-M max_moves] [-s seed]\n"
+                        "       [-f first_index] [-o out_dir] [-B megabytes]\n", argv[0]);
+        return 1;
+    }
+
+    std::mutex mtx;
+    std::vector<Generated> accepted;
+    std::atomic<long> attempts(0);
+    {
+        ThreadPool pool(opt.threads);
+        printf("Generating %d %dx%d levels with %d blocks, %d-%d moves, on %u threads\n",
+               opt.count, opt.width, opt.height, opt.blocks, opt.min_moves, opt.max_moves,
+               pool.size());
+
+        // One long-running task per worker, each with its own seeded stream
+        size_t worker_bytes = opt.max_bytes / pool.size();
+        for (unsigned t = 0; t < pool.size(); ++t)
+        {
+            pool.submit([&, t] {
+                std::mt19937 rng(opt.seed * 7919 + t);
+                while (attempts++ < opt.attempts)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mtx);
+                        if ((int)accepted.size() >= opt.count) return;
+                    }
+
+                    Generated g;
+                    if (!try_candidate(opt, worker_bytes, rng, g)) continue;
+
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if ((int)accepted.size() >= opt.count) return;
+                    accepted.push_back(g);
+                    printf("  found %d/%d (%d moves)\n", (int)accepted.size(), opt.count, g.moves);
+                    fflush(stdout);
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    std::stable_sort(accepted.begin(), accepted.end(),
+                     [](const Generated& a, const Generated& b) { return a.moves < b.moves; });
+
+    for (size_t i = 0; i < accepted.size(); ++i)
+    {
+        const Generated& g = accepted[i];
+        std::string path = opt.out_dir + "/map" + std::to_string(opt.first + i) + ".txt";
+        std::ofstream out(path.c_str());
+        if (!out.is_open())
+        {
+            fprintf(stderr, "Cannot write %s\n", path.c_str());
+            return 1;
+        }
+
+        Level level;
+        State state;
+        build_level(g.rows, g.start_x, g.start_y, level, state);
+        write_map(out, level, state);
+        printf("%s: %d moves\n", path.c_str(), g.moves);
+    }
+
+    printf("%zu of %d levels after %ld candidates\n", accepted.size(), opt.count,
+           std::min(attempts.load(), opt.attempts));
+    return (int)accepted.size() < opt.count ? 1 : 0;
+}
@@ -3,11 +3,14 @@
  */
 
 #include "globals.h"
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 #include <string>
 
 int CURRENT_LEVEL = 0;
-const int NUM_OF_LEVELS = 10;
+int NUM_OF_LEVELS = 10;
 int TOTAL_MOVES = 0;
 int LEVEL_MOVES = 0;
 bool GAME_WON = false;
@@ -18,4 +21,28 @@ int MAP_HEIGHT = 0;
 int OFFSET_X = 2;
 int OFFSET_Y = 1;
 
-std::vector<std::string> GAME_BOARD;
\ No newline at end of file
+std::vector<std::string> GAME_BOARD;
+
+std::string cache_location()
+{
+    std::string base;
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    if (xdg && *xdg) base = xdg;
+    else if (home && *home) base = std::string(home) + "/.cache";
+
+    if (!base.empty())
+    {
+        std::string dir = base + "/vimgames";
+        mkdir(base.c_str(), 0755);
+        mkdir(dir.c_str(), 0755);
+        dir += "/sokoban";
+        mkdir(dir.c_str(), 0755);
+        if (access(dir.c_str(), W_OK) == 0) return dir;
+    }
+
+    const char* tmp = getenv("TMPDIR");
+    std::string dir = std::string(tmp && *tmp ? tmp : "/tmp") + "/vimgames-sokoban";
+    mkdir(dir.c_str(), 0700);
+    return dir;
+}
@@ -10,7 +10,7 @@
 
 // Game state
 extern int CURRENT_LEVEL;
-extern const int NUM_OF_LEVELS;
+extern int NUM_OF_LEVELS; // Set from the level pack at startup
 extern int TOTAL_MOVES;
 extern int LEVEL_MOVES;
 extern bool GAME_WON;
@@ -29,4 +29,10 @@ extern std::vector<std::string> GAME_BOARD;
 #define MAPS_LOCATION "maps"
 #endif
 
+// Writable directory for what the game works out at runtime, created on
+// first use: $XDG_CACHE_HOME/vimgames/sokoban, ~/.cache/vimgames/sokoban,
+// or the temp directory. MAPS_LOCATION may be read-only, e.g. under
+// bazel run, where it holds the checked-in files
+std::string cache_location();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+ * Sokoban - Hint Engine
+ */
+
+#include "hint.h"
+#include "solver_cache.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+
+struct HintEngine
+{
+    std::mutex mtx; // Guards everything but cancel
+    std::condition_variable wake;
+    std::atomic<bool> cancel{false};
+
+    bool started = false;
+    bool has_request = false;
+    bool busy = false;
+    Level level;
+    State state;
+    uint64_t request_hash = 0;
+    uint64_t running_hash = 0;
+    unsigned generation = 0; // Bumped by hint_reset so stale results are dropped
+
+    std::unordered_map<uint64_t, char> cache;
+};
+
+// Never freed: the game leaves through exit(), which must not destroy the
+// engine under a worker that may still be searching
+HintEngine& engine()
+{
+    static HintEngine* e = new HintEngine;
+    return *e;
+}
+
+// Record the hint for every state along the solution, not just the first
+void store(HintEngine& e, const Level& level, State state, const SolveResult& r)
+{
+    for (char action : r.actions)
+    {
+        e.cache[state_hash(level, state)] = action;
+        apply_action(level, state, action);
+    }
+}
+
+void run_worker()
+{
+    HintEngine& e = engine();
+    std::unique_lock<std::mutex> lock(e.mtx);
+    while (true)
+    {
+        e.wake.wait(lock, [&e] { return e.has_request; });
+
+        Level level = e.level;
+        State state = e.state;
+        uint64_t hash = e.request_hash;
+        unsigned generation = e.generation;
+        e.has_request = false;
+        e.busy = true;
+        e.running_hash = hash;
+        e.cancel = false;
+        lock.unlock();
+
+        SolveResult r = solve_cached(level, state, node_budget(level, IN_GAME_SEARCH_BYTES), &e.cancel);
+
+        lock.lock();
+        e.busy = false;
+        if (e.cancel || generation != e.generation) continue;
+
+        if (r.solved) store(e, level, state, r);
+        else e.cache[hash] = HINT_STUCK;
+    }
+}
+
+} // namespace
+
+void hint_request(const Level& level, const State& state)
+{
+    HintEngine& e = engine();
+    uint64_t hash = state_hash(level, state);
+
+    std::lock_guard<std::mutex> lock(e.mtx);
+    if (e.cache.count(hash)) return;
+    if (e.busy && e.running_hash == hash && !e.cancel) return;
+    if (e.has_request && e.request_hash == hash) return;
+
+    if (e.busy) e.cancel = true;
+    e.level = level;
+    e.state = state;
+    e.request_hash = hash;
+    e.has_request = true;
+
+    if (!e.started)
+    {
+        std::thread(run_worker).detach();
+        e.started = true;
+    }
+    e.wake.notify_one();
+}
+
+void hint_cancel()
+{
+    HintEngine& e = engine();
+    std::lock_guard<std::mutex> lock(e.mtx);
+    e.has_request = false;
+    if (e.busy) e.cancel = true;
+}
+
+void hint_reset()
+{
+    HintEngine& e = engine();
+    std::lock_guard<std::mutex> lock(e.mtx);
+    e.has_request = false;
+    if (e.busy) e.cancel = true;
+    e.generation++;
+    e.cache.clear();
+}
+
+char hint_lookup(uint64_t hash)
+{
+    HintEngine& e = engine();
+    std::lock_guard<std::mutex> lock(e.mtx);
+    auto it = e.cache.find(hash);
+    return it == e.cache.end() ? HINT_NONE : it->second;
+}
+
+bool hint_busy()
+{
+    HintEngine& e = engine();
+    std::lock_guard<std::mutex> lock(e.mtx);
+    return e.busy || e.has_request;
+}
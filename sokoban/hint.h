@@ -0,0 +1,38 @@
+/*
+ * Sokoban - Hint Engine
+ *
+ * Runs the solver on a worker thread so the game never waits on a search.
+ * The game asks for a hint whenever the player goes idle and cancels the
+ * search on every move; answers are cached by state hash, together with
+ * every state along the solution found, so undoing or following the hints
+ * gets the next one without searching again.
+ */
+
+#ifndef SOKOBAN_HINT_H
+#define SOKOBAN_HINT_H
+
+#include "board.h"
+#include <cstdint>
+
+// No hint known for the state yet
+const char HINT_NONE = 0;
+// The search finished without finding a solution from the state
+const char HINT_STUCK = '-';
+
+// Start searching from this state unless its hint is cached or already
+// being searched; a search for any other state is cancelled
+void hint_request(const Level& level, const State& state);
+
+// Cancel the running search, if any
+void hint_cancel();
+
+// Forget every cached hint; call when a new level starts
+void hint_reset();
+
+// Next optimal action (h j k l x p), HINT_STUCK or HINT_NONE
+char hint_lookup(uint64_t hash);
+
+// True while the worker is searching
+bool hint_busy();
+
+#endif
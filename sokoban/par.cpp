@@ -0,0 +1,115 @@
+/*
+ * Sokoban - Par Scores
+ */
+
+#include "par.h"
+#include "globals.h"
+#include "solver_cache.h"
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+
+struct ParTable
+{
+    std::mutex mtx;
+    bool loaded = false;
+    std::unordered_map<uint64_t, int> pars;
+    std::unordered_set<uint64_t> requested; // Solved or being solved this run
+};
+
+// Never freed, for the same reason as the hint engine: a solve may still be
+// running when the game exit()s
+ParTable& table()
+{
+    static ParTable* t = new ParTable;
+    return *t;
+}
+
+void read_pars(ParTable& t, const std::string& path)
+{
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return;
+
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        uint64_t key;
+        int par;
+        if (line[0] != '#' && sscanf(line, "%" SCNx64 " %d", &key, &par) == 2 && par > 0)
+        {
+            t.pars[key] = par;
+        }
+    }
+    fclose(f);
+}
+
+void load(ParTable& t)
+{
+    if (t.loaded) return;
+    t.loaded = true;
+    read_pars(t, par_seed_file());
+    read_pars(t, par_file());
+}
+
+// Append one entry; an unwritable cache directory just means no caching
+void save(uint64_t key, int par)
+{
+    std::string path = par_file();
+    FILE* check = fopen(path.c_str(), "r");
+    bool fresh = !check;
+    if (check) fclose(check);
+
+    FILE* f = fopen(path.c_str(), "a");
+    if (!f) return;
+    if (fresh) fprintf(f, "# Sokoban par scores: <level hash> <optimal moves>\n");
+    fprintf(f, "%016" PRIx64 " %d\n", key, par);
+    fclose(f);
+}
+
+} // namespace
+
+std::string par_seed_file()
+{
+    return std::string(MAPS_LOCATION) + "/par.cache";
+}
+
+std::string par_file()
+{
+    return cache_location() + "/par.cache";
+}
+
+void par_request(const Level& level, const State& start)
+{
+    ParTable& t = table();
+    uint64_t key = level_hash(level, start);
+    {
+        std::lock_guard<std::mutex> lock(t.mtx);
+        load(t);
+        if (t.pars.count(key) || !t.requested.insert(key).second) return;
+    }
+
+    std::thread([level, start, key] {
+        SolveResult r = solve_cached(level, start, node_budget(level, IN_GAME_SEARCH_BYTES));
+        if (!r.solved) return;
+
+        ParTable& t = table();
+        std::lock_guard<std::mutex> lock(t.mtx);
+        t.pars[key] = r.moves;
+        save(key, r.moves);
+    }).detach();
+}
+
+int par_lookup(uint64_t key)
+{
+    ParTable& t = table();
+    std::lock_guard<std::mutex> lock(t.mtx);
+    load(t);
+    auto it = t.pars.find(key);
+    return it == t.pars.end() ? PAR_UNKNOWN : it->second;
+}
@@ -0,0 +1,35 @@
+/*
+ * Sokoban - Par Scores
+ *
+ * A level's par is its optimal move count. Pars are worked out by the
+ * solver on a background thread and kept in a sidecar file, keyed by
+ * level_hash(), so each map is only ever solved once and editing a map
+ * invalidates just its own entry. The pars of the shipped maps come in a
+ * read-only file next to them; new ones go to the user's cache.
+ */
+
+#ifndef SOKOBAN_PAR_H
+#define SOKOBAN_PAR_H
+
+#include "board.h"
+#include <cstdint>
+#include <string>
+
+const int PAR_UNKNOWN = 0;
+
+// Checked-in file of '<level hash> <par>' lines for the shipped maps, never
+// written by the game
+std::string par_seed_file();
+
+// File in cache_location() the game appends newly solved pars to, in the
+// same format
+std::string par_file();
+
+// Start computing the par of a level in the background unless it is known
+void par_request(const Level& level, const State& start);
+
+// Par of the level with this hash, or PAR_UNKNOWN while it is still being
+// computed (or the solver gave up on it)
+int par_lookup(uint64_t key);
+
+#endif
@@ -61,6 +61,11 @@ void clear_screen()
     clear();
 }
 
+void get_screen_size(int& rows, int& cols)
+{
+    getmaxyx(stdscr, rows, cols);
+}
+
 void refresh_screen()
 {
     refresh();
@@ -71,6 +76,12 @@ int get_input()
     return getch();
 }
 
+// get_input() returns ERR after ms without a key; -1 blocks again
+void set_input_timeout(int ms)
+{
+    timeout(ms);
+}
+
 void draw_box(int width, int height)
 {
     // Top border
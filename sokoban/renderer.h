@@ -10,8 +10,13 @@ void draw_entity_colored(int x, int y, const std::string& text, int color);
 void draw_text(int x, int y, const std::string& text);
 void draw_text_colored(int x, int y, const std::string& text, int color);
 void clear_screen();
+// Terminal size in rows and columns
+void get_screen_size(int& rows, int& cols);
 void refresh_screen();
 int get_input();
+// get_input() result once the input timeout runs out (ncurses ERR)
+const int NO_INPUT = -1;
+void set_input_timeout(int ms);
 void draw_box(int width, int height);
 void draw_vim_keys(int y, int x);
 void define_colors();
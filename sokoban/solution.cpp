@@ -0,0 +1,53 @@
+/*
+ * Sokoban - Solutions
+ */
+
+#include "solution.h"
+#include "globals.h"
+#include <cstdio>
+#include <sstream>
+
+std::string solution_file()
+{
+    return cache_location() + "/solutions.txt";
+}
+
+void save_solution(const std::string& name, const std::string& actions)
+{
+    std::string path = solution_file();
+    FILE* check = fopen(path.c_str(), "r");
+    bool fresh = !check;
+    if (check) fclose(check);
+
+    FILE* f = fopen(path.c_str(), "a");
+    if (!f) return;
+    if (fresh) fprintf(f, "# Sokoban solutions: <level name> <moves> <actions>\n");
+    fprintf(f, "%s %zu %s\n", name.c_str(), actions.size(), actions.c_str());
+    fclose(f);
+}
+
+bool parse_solution(const std::string& line, std::string& name, int& moves,
+                    std::string& actions)
+{
+    if (line.empty() || line[0] == '#') return false;
+
+    std::istringstream in(line);
+    std::string rest;
+    return (in >> name >> moves >> actions) && !(in >> rest);
+}
+
+bool replay_solution(const Level& level, const State& start, const std::string& actions)
+{
+    State state = start;
+    for (size_t i = 0; i < actions.size(); ++i)
+    {
+        char a = actions[i];
+        if (a != 'h' && a != 'j' && a != 'k' && a != 'l' && a != 'x' && a != 'p') return false;
+        if (!apply_action(level, state, a)) return false;
+
+        // The game ends the level the moment it is solved
+        bool solved = state.unfilled_targets == 0 && !state.holding_block;
+        if (solved) return i + 1 == actions.size();
+    }
+    return false;
+}
@@ -0,0 +1,32 @@
+/*
+ * Sokoban - Solutions
+ *
+ * A finished level is saved as the actions that solved it, one of
+ * h j k l x p per move, so the string's length is the move count. The
+ * solutions file in cache_location() has one '<level name> <moves>
+ * <actions>' line per finish. replay_solution() checks a line against its map with
+ * apply_action(), the rules update_input() plays by, so a claimed score
+ * can be confirmed without trusting whoever sent it.
+ */
+
+#ifndef SOKOBAN_SOLUTION_H
+#define SOKOBAN_SOLUTION_H
+
+#include "board.h"
+#include <string>
+
+// Sidecar file of '<level name> <moves> <actions>' lines
+std::string solution_file();
+
+// Append a finish; an unwritable cache directory just means it is not kept
+void save_solution(const std::string& name, const std::string& actions);
+
+// Split a solutions line; false for comments and malformed lines
+bool parse_solution(const std::string& line, std::string& name, int& moves,
+                    std::string& actions);
+
+// True when every action does something and the level is solved by the
+// last one and not before
+bool replay_solution(const Level& level, const State& start, const std::string& actions);
+
+#endif
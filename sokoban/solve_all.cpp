@@ -0,0 +1,122 @@
+/*
+ * Sokoban - Batch Solver
+ *
+ * Solves every map in a directory (MAPS_LOCATION by default) on all cores
+ * and prints the optimal move count, nodes expanded and wall time of each.
+ * Exits non-zero if any map could not be solved. With -c, maps the solver
+ * cache already knows are answered from it and new solutions are added.
+ * The searches running at once share -B megabytes, half the physical
+ * memory by default, on top of the -n node limit.
+ *
+ * Usage: solve_all [-j threads] [-n max_nodes] [-B megabytes] [-c] [maps_dir]
+ */
+
+#include "board.h"
+#include "globals.h"
+#include "solver.h"
+#include "solver_cache.h"
+#include "thread_pool.h"
+#include "common/levelpack.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> list_maps(const std::string& dir)
+{
+    std::vector<std::string> names;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return names;
+
+    while (dirent* entry = readdir(d))
+    {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".txt") == 0)
+        {
+            names.push_back(name);
+        }
+    }
+    closedir(d);
+
+    std::sort(names.begin(), names.end(), naturalLess);
+    return names;
+}
+
+int main(int argc, char** argv)
+{
+    std::string dir = MAPS_LOCATION;
+    unsigned threads = 0;
+    long max_nodes = DEFAULT_MAX_NODES;
+    size_t max_bytes = batch_search_bytes();
+    bool cached = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) max_nodes = atol(argv[++i]);
+        else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc) max_bytes = (size_t)atol(argv[++i]) << 20;
+        else if (strcmp(argv[i], "-c") == 0) cached = true;
+        else dir = argv[i];
+    }
+
+    std::vector<std::string> maps = list_maps(dir);
+    if (maps.empty())
+    {
+        fprintf(stderr, "No maps found in %s\n", dir.c_str());
+        return 1;
+    }
+
+    std::mutex out;
+    std::atomic<int> unsolved(0);
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        printf("Solving %zu maps from %s on %u threads\n", maps.size(), dir.c_str(), pool.size());
+        size_t worker_bytes = max_bytes / pool.size();
+
+        for (const auto& name : maps)
+        {
+            pool.submit([&, name] {
+                Level level;
+                State state;
+                auto t0 = std::chrono::steady_clock::now();
+                bool loaded = load_level(dir + "/" + name, level, state);
+                SolveResult r = {false, 0, 0, ""};
+                long nodes = loaded ? std::min(max_nodes, node_budget(level, worker_bytes)) : 0;
+                if (loaded && cached) r = solve_cached(level, state, nodes);
+                else if (loaded) r = solve(level, state, nodes);
+                double ms = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - t0).count();
+
+                std::lock_guard<std::mutex> lock(out);
+                if (!loaded)
+                {
+                    printf("%-24s unreadable\n", name.c_str());
+                }
+                else if (r.solved)
+                {
+                    printf("%-24s moves %6d  nodes %10ld  %10.2f ms\n",
+                           name.c_str(), r.moves, r.nodes, ms);
+                }
+                else
+                {
+                    printf("%-24s UNSOLVED     nodes %10ld  %10.2f ms\n",
+                           name.c_str(), r.nodes, ms);
+                }
+                if (!loaded || !r.solved) unsolved++;
+                fflush(stdout);
+            });
+        }
+        pool.wait();
+    }
+
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%zu maps, %d unsolved, %.2f s\n", maps.size(), unsolved.load(), total);
+    return unsolved ? 1 : 0;
+}
@@ -0,0 +1,467 @@
+/*
+ * Sokoban - Solver
+ */
+
+#include "solver.h"
+#include <algorithm>
+#include <queue>
+#include <unistd.h>
+#include <vector>
+
+static const int DIR_X[4] = {-1, 0, 0, 1};
+static const int DIR_Y[4] = {0, 1, -1, 0};
+static const char DIR_KEY[4] = {'h', 'j', 'k', 'l'};
+
+static const uint32_t NONE = 0xFFFFFFFF;
+static const int FAR = 0xFFFF;
+
+// splitmix64 finalizer; Zobrist keys are derived from the cell index so
+// every search and state_hash() agree without sharing a random table
+static uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t block_key(int cell) { return mix((uint64_t)cell * 2); }
+static uint64_t player_key(int cell) { return mix((uint64_t)cell * 2 + 1); }
+static const uint64_t HOLDING_KEY = mix(0xffffffffffffffffULL);
+
+uint64_t state_hash(const Level& level, const State& state)
+{
+    uint64_t h = player_key(cell_index(level, state.px, state.py));
+    if (state.holding_block) h ^= HOLDING_KEY;
+
+    for (int i = 0; i < level.words; ++i)
+    {
+        for (Word w = state.blocks[i]; w; w &= w - 1)
+        {
+            h ^= block_key(i * WORD_BITS + __builtin_ctzll(w));
+        }
+    }
+    return h;
+}
+
+static bool plane_bit(const Word* plane, int bit)
+{
+    return (plane[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
+
+// Search node, one per x/d or p: the player only matters where they act,
+// since blocks never get in the way and the walk between two actions is
+// just the shortest path. Its block plane lives at planes[index * words].
+struct Node
+{
+    uint64_t hash;
+    uint32_t parent;
+    uint32_t g;
+    uint32_t player;
+    uint16_t unfilled;
+    bool holding;
+    char action;
+};
+
+struct OpenEntry
+{
+    uint32_t f, g, node;
+
+    // Lowest f first, deeper nodes first on ties
+    bool operator<(const OpenEntry& o) const
+    {
+        return f != o.f ? f > o.f : g < o.g;
+    }
+};
+
+struct Search
+{
+    const Level& level;
+
+    // The floor the player can reach, renumbered densely; blocks anywhere
+    // else can never be touched, so states only encode these cells
+    int n;
+    int words;
+    std::vector<int> cell;          // Floor id -> cell index
+    std::vector<int> floor_of;      // Cell index -> floor id, or -1
+    std::vector<int> next;          // Floor id * 4 + dir -> floor id, or -1
+    std::vector<int> targets;       // Floor ids of targets
+    std::vector<Word> target_plane; // Targets as a floor plane
+    std::vector<std::vector<uint16_t>> rows; // Walking distances per floor id, filled on first use
+    std::vector<uint64_t> bkey, pkey;
+    std::vector<int> block_ids;     // Scratch for heuristic()
+
+    std::vector<Node> nodes;
+    std::vector<Word> planes;
+    std::vector<uint32_t> table; // Transposition table of node indices
+    std::priority_queue<OpenEntry> open;
+
+    Search(const Level& l) : level(l), n(0), words(0) {}
+
+    void build_graph(const State& start)
+    {
+        floor_of.assign(level.width * level.height, -1);
+        int origin = cell_index(level, start.px, start.py);
+        floor_of[origin] = 0;
+        cell.push_back(origin);
+
+        // The start may sit on a wall (map6 does), so it is always floor
+        for (size_t i = 0; i < cell.size(); ++i)
+        {
+            int x = cell[i] % level.width, y = cell[i] / level.width;
+            for (int d = 0; d < 4; ++d)
+            {
+                int nx = x + DIR_X[d], ny = y + DIR_Y[d];
+                if (!in_bounds(level, nx, ny)) continue;
+                int c = cell_index(level, nx, ny);
+                if (test_bit(level.walls, c) || floor_of[c] != -1) continue;
+                floor_of[c] = cell.size();
+                cell.push_back(c);
+            }
+        }
+
+        n = cell.size();
+        words = (n + WORD_BITS - 1) / WORD_BITS;
+        next.assign(n * 4, -1);
+        target_plane.assign(words, 0);
+        bkey.resize(n);
+        pkey.resize(n);
+
+        for (int i = 0; i < n; ++i)
+        {
+            int x = cell[i] % level.width, y = cell[i] / level.width;
+            for (int d = 0; d < 4; ++d)
+            {
+                int nx = x + DIR_X[d], ny = y + DIR_Y[d];
+                if (!in_bounds(level, nx, ny)) continue;
+                int c = cell_index(level, nx, ny);
+                if (!test_bit(level.walls, c)) next[i * 4 + d] = floor_of[c];
+            }
+            if (test_bit(level.targets, cell[i]))
+            {
+                targets.push_back(i);
+                flip_bit(target_plane, i);
+            }
+            bkey[i] = block_key(cell[i]);
+            pkey[i] = player_key(cell[i]);
+        }
+
+        // Walls never move, so every distance is fixed for the whole search
+        rows.resize(n);
+    }
+
+    // Walking distance from floor id 'from' to every floor id
+    const std::vector<uint16_t>& distances(int from)
+    {
+        std::vector<uint16_t>& d = rows[from];
+        if (!d.empty()) return d;
+
+        d.assign(n, FAR);
+        std::vector<int> queue(n);
+        int head = 0, tail = 0;
+        d[from] = 0;
+        queue[tail++] = from;
+        while (head < tail)
+        {
+            int f = queue[head++];
+            for (int k = 0; k < 4; ++k)
+            {
+                int m = next[f * 4 + k];
+                if (m != -1 && d[m] == FAR)
+                {
+                    d[m] = d[f] + 1;
+                    queue[tail++] = m;
+                }
+            }
+        }
+        return d;
+    }
+
+    // h/j/k/l keys of a shortest walk between two floor ids, traced back
+    // from 'to' since the start may be a wall nothing can step back onto
+    std::string walk(int from, int to)
+    {
+        const std::vector<uint16_t>& d = distances(from);
+        std::string keys;
+        while (to != from)
+        {
+            int x = cell[to] % level.width, y = cell[to] / level.width;
+            for (int k = 0; k < 4; ++k)
+            {
+                int px = x - DIR_X[k], py = y - DIR_Y[k];
+                if (!in_bounds(level, px, py)) continue;
+                int m = floor_of[cell_index(level, px, py)];
+                if (m != -1 && next[m * 4 + k] == to && d[m] + 1 == d[to])
+                {
+                    keys += DIR_KEY[k];
+                    to = m;
+                    break;
+                }
+            }
+        }
+        std::reverse(keys.begin(), keys.end());
+        return keys;
+    }
+
+    // Lower bound on the moves left, or NONE when some unfilled target can
+    // no longer get a block. Every unfilled target needs a p, and an x for
+    // each block the player is not already carrying. On top of that it needs
+    // a carrying walk from its closest loose block (or the player, while
+    // holding), and all but the last target filled need an empty walk on to
+    // the next loose block, as does the player when their hands are empty.
+    uint32_t heuristic(const Word* plane, int player, bool holding, int unfilled)
+    {
+        if (unfilled == 0) return holding ? 1 : 0;
+
+        block_ids.clear();
+        for (int i = 0; i < words; ++i)
+        {
+            for (Word w = plane[i] & ~target_plane[i]; w; w &= w - 1)
+            {
+                block_ids.push_back(i * WORD_BITS + __builtin_ctzll(w));
+            }
+        }
+        if ((int)block_ids.size() + (holding ? 1 : 0) < unfilled) return NONE;
+
+        const std::vector<uint16_t>& from_player = distances(player);
+        uint32_t h = unfilled + (unfilled - (holding ? 1 : 0));
+        int longest_empty = 0;
+        for (size_t t = 0; t < targets.size(); ++t)
+        {
+            if (plane_bit(plane, targets[t])) continue;
+
+            const std::vector<uint16_t>& d = distances(targets[t]);
+            int empty = FAR;
+            for (int b : block_ids) empty = std::min(empty, (int)d[b]);
+            int carry = holding ? std::min(empty, (int)from_player[targets[t]]) : empty;
+            if (carry == FAR) return NONE;
+
+            h += carry;
+            if (empty != FAR)
+            {
+                h += empty;
+                longest_empty = std::max(longest_empty, empty);
+            }
+        }
+        h -= longest_empty;
+
+        if (!holding)
+        {
+            int approach = FAR;
+            for (int b : block_ids) approach = std::min(approach, (int)from_player[b]);
+            h += approach;
+        }
+        return h;
+    }
+
+    bool same(uint32_t a, const Node& b, const Word* plane) const
+    {
+        const Node& n = nodes[a];
+        return n.hash == b.hash && n.player == b.player && n.holding == b.holding &&
+               std::equal(plane, plane + words, &planes[(size_t)a * words]);
+    }
+
+    // Slot holding an equal node, or the empty slot where it belongs
+    size_t probe(const Node& node, const Word* plane) const
+    {
+        size_t mask = table.size() - 1;
+        size_t slot = node.hash & mask;
+        while (table[slot] != NONE && !same(table[slot], node, plane))
+        {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void grow()
+    {
+        std::vector<uint32_t> old;
+        old.swap(table);
+        table.assign(old.size() * 2, NONE);
+        size_t mask = table.size() - 1;
+        for (uint32_t idx : old)
+        {
+            if (idx == NONE) continue;
+            size_t slot = nodes[idx].hash & mask;
+            while (table[slot] != NONE) slot = (slot + 1) & mask;
+            table[slot] = idx;
+        }
+    }
+
+    // Record a successor unless an equal state was already reached as cheaply
+    void add(const Node& node, const Word* plane)
+    {
+        uint32_t h = heuristic(plane, node.player, node.holding, node.unfilled);
+        if (h == NONE) return;
+        if ((nodes.size() + 1) * 2 > table.size()) grow();
+
+        size_t slot = probe(node, plane);
+        uint32_t idx = table[slot];
+        if (idx != NONE)
+        {
+            if (nodes[idx].g <= node.g) return;
+            nodes[idx].g = node.g;
+            nodes[idx].parent = node.parent;
+            nodes[idx].action = node.action;
+        }
+        else
+        {
+            idx = nodes.size();
+            table[slot] = idx;
+            nodes.push_back(node);
+            planes.insert(planes.end(), plane, plane + words);
+        }
+
+        OpenEntry e = {node.g + h, node.g, idx};
+        open.push(e);
+    }
+
+    std::string path_to(uint32_t idx)
+    {
+        std::vector<uint32_t> chain;
+        for (; idx != NONE; idx = nodes[idx].parent)
+        {
+            chain.push_back(idx);
+        }
+
+        std::string actions;
+        for (size_t i = chain.size() - 1; i > 0; --i)
+        {
+            const Node& from = nodes[chain[i]];
+            const Node& to = nodes[chain[i - 1]];
+            actions += walk(from.player, to.player);
+            actions += to.action;
+        }
+        return actions;
+    }
+};
+
+long node_budget(const Level& level, size_t max_bytes)
+{
+    size_t floor = 0;
+    for (int i = 0; i < level.width * level.height; ++i)
+    {
+        if (!test_bit(level.walls, i)) floor++;
+    }
+
+    // Walking distances take up to a row per floor cell, though only the
+    // cells the search reaches fill theirs; nodes keep at least half the
+    // budget. Every stored node keeps its record and block plane, an open
+    // entry and up to four transposition slots, the table being grown to
+    // stay half empty
+    size_t words = (floor + WORD_BITS - 1) / WORD_BITS;
+    size_t rows = floor * floor * sizeof(uint16_t);
+    size_t per_node = sizeof(Node) + words * sizeof(Word) + sizeof(OpenEntry) + 4 * sizeof(uint32_t);
+    size_t left = max_bytes - std::min(rows, max_bytes / 2);
+    return std::max<long>(1, left / per_node);
+}
+
+size_t batch_search_bytes()
+{
+    long pages = sysconf(_SC_PHYS_PAGES), page_size = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || page_size <= 0) return (size_t)4 << 30;
+    return (size_t)pages * page_size / 2;
+}
+
+SolveResult solve(const Level& level, const State& start, long max_nodes,
+                  const std::atomic<bool>* cancel)
+{
+    SolveResult result;
+    result.solved = false;
+    result.moves = 0;
+    result.nodes = 0;
+
+    Search search(level);
+    search.build_graph(start);
+    const int words = search.words;
+
+    // Encode the start on the reachable floor
+    std::vector<Word> plane(words, 0);
+    for (int i = 0; i < search.n; ++i)
+    {
+        if (test_bit(start.blocks, search.cell[i])) flip_bit(plane, i);
+    }
+
+    // An unfilled target off the reachable floor can never be filled, and
+    // the heuristic rejects a floor with fewer blocks than unfilled targets
+    int unfilled = 0;
+    for (int t : search.targets)
+    {
+        if (!test_bit(plane, t)) unfilled++;
+    }
+    if (unfilled != start.unfilled_targets)
+    {
+        return result;
+    }
+
+    search.table.assign(1 << 16, NONE);
+    Node root;
+    root.hash = state_hash(level, start);
+    root.parent = NONE;
+    root.g = 0;
+    root.player = 0;
+    root.unfilled = unfilled;
+    root.holding = start.holding_block;
+    root.action = 0;
+    search.add(root, plane.data());
+
+    std::vector<Word> scratch(words);
+    while (!search.open.empty())
+    {
+        OpenEntry e = search.open.top();
+        search.open.pop();
+        Node node = search.nodes[e.node];
+        if (e.g != node.g) continue; // Stale entry, reached cheaper since
+
+        if (node.unfilled == 0 && !node.holding)
+        {
+            result.solved = true;
+            result.moves = node.g;
+            result.actions = search.path_to(e.node);
+            return result;
+        }
+
+        if (++result.nodes >= max_nodes || (long)search.nodes.size() >= max_nodes) break;
+        if (cancel && cancel->load()) break;
+
+        std::copy(&search.planes[(size_t)e.node * words],
+                  &search.planes[(size_t)e.node * words] + words, scratch.begin());
+        const std::vector<uint16_t>& d = search.distances(node.player);
+
+        // A block is only ever lifted from a cell that is not a target and
+        // dropped on an unfilled target: parking it anywhere else means
+        // walking back for it later, which never beats delivering it directly.
+        // Only a block held with every target filled goes on a free cell.
+        for (int i = 0; i < words; ++i)
+        {
+            Word w;
+            if (!node.holding) w = scratch[i] & ~search.target_plane[i];
+            else if (node.unfilled > 0) w = search.target_plane[i] & ~scratch[i];
+            else w = ~scratch[i];
+
+            for (; w; w &= w - 1)
+            {
+                int c = i * WORD_BITS + __builtin_ctzll(w);
+                if (c >= search.n || d[c] == FAR) continue;
+                if (test_bit(level.walls, search.cell[c])) continue; // The start cell
+
+                bool target = test_bit(search.target_plane, c);
+                Node child;
+                child.hash = node.hash ^ search.pkey[node.player] ^ search.pkey[c] ^
+                             search.bkey[c] ^ HOLDING_KEY;
+                child.parent = e.node;
+                child.g = node.g + d[c] + 1;
+                child.player = c;
+                child.unfilled = node.unfilled + (target ? (node.holding ? -1 : 1) : 0);
+                child.holding = !node.holding;
+                child.action = node.holding ? 'p' : 'x';
+
+                flip_bit(scratch, c);
+                search.add(child, scratch.data());
+                flip_bit(scratch, c);
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,47 @@
+/*
+ * Sokoban - Solver
+ *
+ * Optimal A* search for this variant's rules: the player walks over
+ * anything but walls, cuts the block under them with x/d and pastes it
+ * back with p. Every successful action costs one move, as in update_input().
+ */
+
+#ifndef SOKOBAN_SOLVER_H
+#define SOKOBAN_SOLVER_H
+
+#include "board.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+const long DEFAULT_MAX_NODES = 5000000;
+
+// Memory one in-game search may use; a hint and a par search can run at once
+const size_t IN_GAME_SEARCH_BYTES = 128 << 20;
+
+struct SolveResult
+{
+    bool solved;
+    int moves;           // Minimal move count when solved
+    long nodes;          // Nodes expanded
+    std::string actions; // One of h j k l x p per move
+};
+
+// Zobrist key of the whole state, matching the hashes the solver uses
+uint64_t state_hash(const Level& level, const State& state);
+
+// Largest max_nodes whose search of this level fits in max_bytes
+long node_budget(const Level& level, size_t max_bytes);
+
+// Memory the batch tools share out among their worker threads by default:
+// half the machine's physical memory
+size_t batch_search_bytes();
+
+// Search stops unsolved once it has expanded or stored max_nodes nodes, or
+// once *cancel is set
+SolveResult solve(const Level& level, const State& start,
+                  long max_nodes = DEFAULT_MAX_NODES,
+                  const std::atomic<bool>* cancel = nullptr);
+
+#endif
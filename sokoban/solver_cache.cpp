@@ -0,0 +1,330 @@
+/*
+ * Sokoban - Persistent Solver Cache
+ */
+
+#include "solver_cache.h"
+#include "globals.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+const char CACHE_MAGIC[4] = {'S', 'V', 'C', '1'};
+const uint32_t CACHE_VERSION = 1;
+const size_t HEADER_SIZE = 16; // Magic, version, table slots, table records
+const size_t MIN_LOG_BEFORE_COMPACT = 1024;
+
+struct Record
+{
+    uint64_t layout, state; // Both 0 marks an empty table slot
+    uint32_t moves;
+    char action;
+    char pad[3];
+};
+
+typedef std::pair<uint64_t, uint64_t> Key;
+
+uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+struct KeyHash
+{
+    size_t operator()(const Key& k) const { return mix(k.first ^ mix(k.second)); }
+};
+
+struct SolverCache
+{
+    std::mutex mtx;
+    bool opened = false;
+
+    void* map = nullptr; // The whole file, table and log
+    size_t map_size = 0;
+    const Record* table = nullptr;
+    uint32_t slots = 0;
+    uint32_t table_records = 0;
+
+    // Records appended since the last compaction, read from the log at
+    // startup and added to it since
+    std::unordered_map<Key, Record, KeyHash> log;
+};
+
+// Never freed, like the hint engine: workers may still use it at exit()
+SolverCache& cache()
+{
+    static SolverCache* c = new SolverCache;
+    return *c;
+}
+
+void unmap(SolverCache& c)
+{
+    if (c.map) munmap(c.map, c.map_size);
+    c.map = nullptr;
+    c.map_size = 0;
+    c.table = nullptr;
+    c.slots = 0;
+    c.table_records = 0;
+}
+
+void remember(SolverCache& c, const Record& r)
+{
+    auto it = c.log.find(Key(r.layout, r.state));
+    if (it == c.log.end() || r.moves < it->second.moves) c.log[Key(r.layout, r.state)] = r;
+}
+
+// Map the file and load its log; a missing or foreign file reads as empty
+void load(SolverCache& c)
+{
+    unmap(c);
+    c.log.clear();
+
+    int fd = open(solver_cache_file().c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= HEADER_SIZE)
+    {
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            c.map = map;
+            c.map_size = st.st_size;
+        }
+    }
+    close(fd);
+    if (!c.map) return;
+
+    const char* base = (const char*)c.map;
+    uint32_t header[3];
+    memcpy(header, base + 4, sizeof(header));
+    size_t table_end = HEADER_SIZE + (size_t)header[1] * sizeof(Record);
+    bool valid = memcmp(base, CACHE_MAGIC, 4) == 0 && header[0] == CACHE_VERSION &&
+                 (header[1] & (header[1] - 1)) == 0 && table_end <= c.map_size;
+    if (!valid)
+    {
+        unmap(c);
+        return;
+    }
+
+    c.slots = header[1];
+    c.table_records = header[2];
+    c.table = (const Record*)(base + HEADER_SIZE);
+
+    const Record* log = (const Record*)(base + table_end);
+    size_t count = (c.map_size - table_end) / sizeof(Record);
+    for (size_t i = 0; i < count; ++i)
+    {
+        remember(c, log[i]);
+    }
+}
+
+const Record* find(SolverCache& c, uint64_t layout, uint64_t state)
+{
+    auto it = c.log.find(Key(layout, state));
+    const Record* best = it == c.log.end() ? nullptr : &it->second;
+
+    if (c.slots == 0) return best;
+    for (uint32_t i = KeyHash()(Key(layout, state)) & (c.slots - 1);; i = (i + 1) & (c.slots - 1))
+    {
+        const Record& r = c.table[i];
+        if (r.layout == 0 && r.state == 0) return best;
+        if (r.layout == layout && r.state == state)
+        {
+            return best && best->moves <= r.moves ? best : &r;
+        }
+    }
+}
+
+void ensure_open(SolverCache& c)
+{
+    if (c.opened) return;
+    c.opened = true;
+    load(c);
+}
+
+bool write_all(int fd, const void* data, size_t size)
+{
+    const char* p = (const char*)data;
+    while (size > 0)
+    {
+        ssize_t n = write(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Rewrite the file as one table holding the best record for every key
+void compact(SolverCache& c)
+{
+    std::vector<Record> all;
+    for (uint32_t i = 0; i < c.slots; ++i)
+    {
+        const Record& r = c.table[i];
+        if (r.layout == 0 && r.state == 0) continue;
+        if (!c.log.count(Key(r.layout, r.state))) all.push_back(r);
+    }
+    for (const auto& entry : c.log)
+    {
+        const Record* r = find(c, entry.first.first, entry.first.second);
+        all.push_back(*r);
+    }
+
+    // At most half full, so probes stay short
+    uint32_t slots = 64;
+    while (slots < all.size() * 2) slots *= 2;
+    std::vector<Record> table(slots);
+    memset(table.data(), 0, slots * sizeof(Record));
+    for (const Record& r : all)
+    {
+        uint32_t i = KeyHash()(Key(r.layout, r.state)) & (slots - 1);
+        while (table[i].layout != 0 || table[i].state != 0) i = (i + 1) & (slots - 1);
+        table[i] = r;
+    }
+
+    std::string path = solver_cache_file();
+    std::string tmp = path + ".tmp";
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+
+    uint32_t header[3] = {CACHE_VERSION, slots, (uint32_t)all.size()};
+    bool ok = write_all(fd, CACHE_MAGIC, 4) && write_all(fd, header, sizeof(header)) &&
+              write_all(fd, table.data(), slots * sizeof(Record));
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        unlink(tmp.c_str());
+        return;
+    }
+    load(c);
+}
+
+void append(SolverCache& c, const std::vector<Record>& records)
+{
+    for (const Record& r : records)
+    {
+        remember(c, r);
+    }
+
+    int fd = open(solver_cache_file().c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) return;
+
+    // A new file starts with an empty table
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size == 0)
+    {
+        uint32_t header[3] = {CACHE_VERSION, 0, 0};
+        write_all(fd, CACHE_MAGIC, 4);
+        write_all(fd, header, sizeof(header));
+    }
+    write_all(fd, records.data(), records.size() * sizeof(Record));
+    close(fd);
+
+    if (c.log.size() > std::max<size_t>(MIN_LOG_BEFORE_COMPACT, c.table_records / 2)) compact(c);
+}
+
+} // namespace
+
+std::string solver_cache_file()
+{
+    return cache_location() + "/solver.cache";
+}
+
+bool solver_cache_lookup(uint64_t layout, uint64_t state, CachedMove& out)
+{
+    SolverCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mtx);
+    ensure_open(c);
+
+    const Record* r = find(c, layout, state);
+    if (!r) return false;
+    out.moves = r->moves;
+    out.action = r->action;
+    return true;
+}
+
+void solver_cache_store(const Level& level, const State& start, const SolveResult& result)
+{
+    if (!result.solved) return;
+
+    uint64_t layout = layout_hash(level);
+    std::vector<Record> records;
+    State state = start;
+    for (size_t i = 0; i <= result.actions.size(); ++i)
+    {
+        Record r;
+        memset(&r, 0, sizeof(r));
+        r.layout = layout;
+        r.state = state_hash(level, state);
+        r.moves = result.actions.size() - i;
+        r.action = i < result.actions.size() ? result.actions[i] : 0;
+        records.push_back(r);
+        if (i < result.actions.size()) apply_action(level, state, result.actions[i]);
+    }
+
+    SolverCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mtx);
+    ensure_open(c);
+
+    // Only what improves on what is known
+    std::vector<Record> fresh;
+    for (const Record& r : records)
+    {
+        const Record* known = find(c, r.layout, r.state);
+        if (!known || r.moves < known->moves) fresh.push_back(r);
+    }
+    if (!fresh.empty()) append(c, fresh);
+}
+
+void solver_cache_compact()
+{
+    SolverCache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mtx);
+    ensure_open(c);
+    compact(c);
+}
+
+SolveResult solve_cached(const Level& level, const State& start, long max_nodes,
+                         const std::atomic<bool>* cancel)
+{
+    // Follow the cached next actions; every step must be one move closer
+    uint64_t layout = layout_hash(level);
+    SolveResult result = {false, 0, 0, ""};
+    State state = start;
+    CachedMove move;
+    if (solver_cache_lookup(layout, state_hash(level, state), move))
+    {
+        int left = move.moves;
+        result.moves = left;
+        while (left > 0 && move.moves == left && apply_action(level, state, move.action))
+        {
+            result.actions += move.action;
+            left--;
+            if (!solver_cache_lookup(layout, state_hash(level, state), move)) break;
+        }
+        if (left == 0 && move.moves == 0 && state.unfilled_targets == 0 && !state.holding_block)
+        {
+            result.solved = true;
+            return result;
+        }
+    }
+
+    result = solve(level, start, max_nodes, cancel);
+    if (result.solved) solver_cache_store(level, start, result);
+    return result;
+}
@@ -0,0 +1,45 @@
+/*
+ * Sokoban - Persistent Solver Cache
+ *
+ * Remembers, across runs, the optimal number of moves left and the next
+ * action for every state on every solution the solver has found, keyed
+ * by (layout_hash, state_hash). The file in cache_location() holds a hash
+ * table followed by an append-only log. Lookups probe the memory-mapped
+ * table, new results are appended to the log, and once the log grows
+ * past half the table both are compacted into a new table. Records are
+ * in host byte order; the file is a cache, not an interchange format.
+ */
+
+#ifndef SOKOBAN_SOLVER_CACHE_H
+#define SOKOBAN_SOLVER_CACHE_H
+
+#include "board.h"
+#include "solver.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+struct CachedMove
+{
+    int moves;   // Optimal moves left from the state
+    char action; // Next action on an optimal solution; 0 when solved
+};
+
+// Cache file; an unwritable cache directory just keeps the cache in memory
+std::string solver_cache_file();
+
+bool solver_cache_lookup(uint64_t layout, uint64_t state, CachedMove& out);
+
+// Record every state along a solution found from start
+void solver_cache_store(const Level& level, const State& start, const SolveResult& result);
+
+// Fold the log into the table now instead of waiting for it to grow
+void solver_cache_compact();
+
+// solve(), answered from the cache when it holds a full solution from
+// start; nodes is 0 then. Solutions found by searching are stored.
+SolveResult solve_cached(const Level& level, const State& start,
+                         long max_nodes = DEFAULT_MAX_NODES,
+                         const std::atomic<bool>* cancel = nullptr);
+
+#endif
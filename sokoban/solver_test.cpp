@@ -0,0 +1,177 @@
+/*
+ * Sokoban - Solver Tests
+ *
+ * Checks solve() against a plain breadth-first search over every state
+ * on random small maps: the same verdict, the same minimal move count,
+ * and actions that replay to a win with apply_action(). Also checks that
+ * node budgets hold.
+ */
+
+#include "board.h"
+#include "solver.h"
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do                                                                \
+    {                                                                 \
+        if (!(cond))                                                  \
+        {                                                             \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+static const char ACTIONS[] = "hjklxp";
+
+// The whole state as a string, for the search's visited set
+static std::string state_key(const State& state)
+{
+    std::string key((const char*)state.blocks.data(), state.blocks.size() * sizeof(Word));
+    key += (char)state.px;
+    key += (char)state.py;
+    key += state.holding_block ? 'h' : '-';
+    return key;
+}
+
+static bool won(const State& state)
+{
+    return state.unfilled_targets == 0 && !state.holding_block;
+}
+
+// Fewest moves to win by trying every action from every state, or -1
+static int bfs_moves(const Level& level, const State& start)
+{
+    if (won(start)) return 0;
+
+    std::unordered_map<std::string, int> seen;
+    std::queue<State> open;
+    seen[state_key(start)] = 0;
+    open.push(start);
+    while (!open.empty())
+    {
+        State state = open.front();
+        open.pop();
+        int moves = seen[state_key(state)];
+        for (const char* a = ACTIONS; *a; ++a)
+        {
+            State next = state;
+            if (!apply_action(level, next, *a)) continue;
+            if (won(next)) return moves + 1;
+            if (seen.emplace(state_key(next), moves + 1).second) open.push(next);
+        }
+    }
+    return -1;
+}
+
+// A walled map of 4..7 x 3..5 inner cells with a few walls, blocks and
+// targets; some have more targets than blocks, so cannot be won
+static void random_map(Level& level, State& state)
+{
+    int w = 4 + rand() % 4, h = 3 + rand() % 3;
+    std::vector<std::string> rows(h + 2, std::string(w + 2, '#'));
+    for (int y = 1; y <= h; ++y)
+    {
+        for (int x = 1; x <= w; ++x)
+        {
+            rows[y][x] = rand() % 6 == 0 ? '#' : '.';
+        }
+    }
+
+    int blocks = 1 + rand() % 3, targets = 1 + rand() % 3;
+    auto place = [&](char c) {
+        for (;;)
+        {
+            int x = 1 + rand() % w, y = 1 + rand() % h;
+            if (rows[y][x] != '.' || (x == 1 && y == 1)) continue;
+            rows[y][x] = c;
+            return;
+        }
+    };
+    for (int i = 0; i < blocks; ++i) place('B');
+    for (int i = 0; i < targets; ++i) place('T');
+    rows[1][1] = '.';
+    build_level(rows, 1, 1, level, state);
+}
+
+static void test_matches_bfs()
+{
+    srand(1);
+    int solvable = 0;
+    for (int i = 0; i < 1500; ++i)
+    {
+        Level level;
+        State start;
+        random_map(level, start);
+
+        int expected = bfs_moves(level, start);
+        SolveResult r = solve(level, start);
+        CHECK(r.solved == (expected >= 0));
+        if (!r.solved || expected < 0) continue;
+        solvable++;
+
+        CHECK(r.moves == expected);
+        CHECK((int)r.actions.size() == r.moves);
+
+        State state = start;
+        bool replayed = true;
+        for (char a : r.actions)
+        {
+            replayed = replayed && apply_action(level, state, a);
+        }
+        CHECK(replayed && won(state));
+    }
+    CHECK(solvable > 100); // The maps are not all dead ends
+}
+
+static void test_node_budget()
+{
+    std::vector<std::string> small(5, "#......#");
+    small[0] = small[4] = "########";
+    small[2] = "#.B..T.#";
+    std::vector<std::string> large(60, '#' + std::string(98, '.') + '#');
+    large[0] = large[59] = std::string(100, '#');
+
+    Level a, b;
+    State sa, sb;
+    build_level(small, 1, 1, a, sa);
+    build_level(large, 1, 1, b, sb);
+
+    CHECK(node_budget(a, 1 << 20) >= 1);
+    CHECK(node_budget(a, 64 << 20) > node_budget(a, 1 << 20));
+    CHECK(node_budget(b, 64 << 20) < node_budget(a, 64 << 20)); // Wider planes
+    CHECK(node_budget(b, 0) == 1);
+
+    // Four blocks to carry take at least eight expansions, so a budget of
+    // five gives up
+    for (int i = 0; i < 4; ++i)
+    {
+        large[10 + i * 10][20 + i * 15] = 'B';
+        large[15 + i * 10][80 - i * 15] = 'T';
+    }
+    build_level(large, 1, 1, b, sb);
+    SolveResult r = solve(b, sb, 5);
+    CHECK(!r.solved);
+    CHECK(r.nodes <= 5);
+    CHECK(solve(b, sb, node_budget(b, 64 << 20)).solved);
+}
+
+int main()
+{
+    test_matches_bfs();
+    test_node_budget();
+
+    if (failures > 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All solver tests passed\n");
+    return 0;
+}
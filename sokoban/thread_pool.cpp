@@ -0,0 +1,107 @@
+/*
+ * Sokoban - Work-Stealing Thread Pool
+ */
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        queues.emplace_back(new Queue);
+    }
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    unsigned target;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        target = next_queue++ % queues.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mtx);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        queued++;
+        pending++;
+    }
+    work_ready.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    all_done.wait(lock, [this] { return pending == 0; });
+}
+
+// Own queue from the back, then everybody else's from the front
+bool ThreadPool::take(unsigned self, std::function<void()>& task)
+{
+    for (unsigned i = 0; i < queues.size(); ++i)
+    {
+        Queue& q = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.tasks.empty()) continue;
+
+        if (i == 0)
+        {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned self)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            work_ready.wait(lock, [this] { return stopping || queued > 0; });
+            if (queued == 0) return; // Stopping with nothing left to do
+            queued--;
+        }
+
+        // One task is reserved for us; a scan can still miss it while other
+        // workers move through the queues, so look again until we get it
+        std::function<void()> task;
+        while (!take(self, task))
+        {
+            std::this_thread::yield();
+        }
+        task();
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--pending == 0) all_done.notify_all();
+    }
+}
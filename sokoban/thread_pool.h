@@ -0,0 +1,56 @@
+/*
+ * Sokoban - Work-Stealing Thread Pool
+ *
+ * Each worker owns a task deque and runs its newest task first; a worker
+ * that runs dry steals the oldest task from another worker, so a few long
+ * jobs (hard maps) do not leave the other cores idle.
+ */
+
+#ifndef SOKOBAN_THREAD_POOL_H
+#define SOKOBAN_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished
+    void wait();
+
+    unsigned size() const { return workers.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool take(unsigned self, std::function<void()>& task);
+    void run(unsigned self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mtx; // Guards the counters below
+    std::condition_variable work_ready;
+    std::condition_variable all_done;
+    size_t queued = 0;  // Submitted but not yet taken
+    size_t pending = 0; // Submitted but not yet finished
+    unsigned next_queue = 0;
+    bool stopping = false;
+};
+
+#endif
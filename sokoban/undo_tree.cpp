@@ -0,0 +1,105 @@
+/*
+ * Sokoban - Undo Tree
+ */
+
+#include "undo_tree.h"
+#include <algorithm>
+
+void undo_reset(UndoTree& tree)
+{
+    UndoNode root;
+    root.parent = -1;
+    root.delta.dx = 0;
+    root.delta.dy = 0;
+    root.delta.was_holding = false;
+    root.depth = 0;
+    root.redo_child = -1;
+
+    tree.nodes.assign(1, root);
+    tree.current = 0;
+}
+
+void undo_record(UndoTree& tree, const Delta& d, int moves)
+{
+    UndoNode node;
+    node.parent = tree.current;
+    node.delta = d;
+    node.depth = tree.nodes[tree.current].depth + moves;
+    node.redo_child = -1;
+
+    tree.nodes.push_back(node);
+    tree.current = tree.nodes.size() - 1;
+    tree.nodes[node.parent].redo_child = tree.current;
+}
+
+bool undo_jump(UndoTree& tree, const Level& level, State& state, int node)
+{
+    if (node < 0 || node >= (int)tree.nodes.size()) return false;
+
+    // Parents have lower numbers, so stepping up from the higher side meets
+    // at the common ancestor
+    std::vector<int> down;
+    int up = tree.current;
+    while (up != node)
+    {
+        if (up > node)
+        {
+            revert(level, state, tree.nodes[up].delta);
+            up = tree.nodes[up].parent;
+        }
+        else
+        {
+            down.push_back(node);
+            node = tree.nodes[node].parent;
+        }
+    }
+
+    std::reverse(down.begin(), down.end());
+    for (int n : down)
+    {
+        replay(level, state, tree.nodes[n].delta);
+        tree.nodes[tree.nodes[n].parent].redo_child = n;
+        tree.current = n;
+    }
+    if (down.empty()) tree.current = up;
+    return true;
+}
+
+std::string undo_path(const UndoTree& tree)
+{
+    std::vector<int> path;
+    for (int n = tree.current; n > 0; n = tree.nodes[n].parent)
+    {
+        path.push_back(n);
+    }
+
+    std::string actions;
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        actions += tree.nodes[*it].delta.actions;
+    }
+    return actions;
+}
+
+void revert(const Level& level, State& state, const Delta& d)
+{
+    state.px -= d.dx;
+    state.py -= d.dy;
+    state.holding_block = d.was_holding;
+    for (int cell : d.flipped)
+    {
+        toggle_block(level, state, cell);
+    }
+}
+
+// Every flip is a pick or a put, each of which swaps what the player holds
+void replay(const Level& level, State& state, const Delta& d)
+{
+    state.px += d.dx;
+    state.py += d.dy;
+    state.holding_block = d.was_holding != (d.flipped.size() % 2 == 1);
+    for (int cell : d.flipped)
+    {
+        toggle_block(level, state, cell);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Sokoban - Undo Tree
+ *
+ * Vim-style undo history: a move made after an undo starts a new branch
+ * instead of discarding the old one. Every node stores only the Delta from
+ * its parent, so branches share everything they did not change and the
+ * whole tree costs a few bytes per move however large the map.
+ */
+
+#ifndef SOKOBAN_UNDO_TREE_H
+#define SOKOBAN_UNDO_TREE_H
+
+#include "board.h"
+#include <string>
+#include <vector>
+
+// What one history entry changed
+struct Delta
+{
+    int dx, dy;
+    bool was_holding;
+    std::vector<int> flipped; // Cells whose block bit the entry toggled
+    std::string actions;      // h j k l x p as played, one per move
+};
+
+struct UndoNode
+{
+    int parent;     // -1 for the level start
+    Delta delta;    // From the parent's state to this one
+    int depth;      // Moves from the level start
+    int redo_child; // Where Ctrl-R goes: the child made or visited last, or -1
+};
+
+// Nodes are numbered in the order they were made, which is the order g-
+// and g+ walk; a parent always comes before its children
+struct UndoTree
+{
+    std::vector<UndoNode> nodes;
+    int current;
+};
+
+void undo_reset(UndoTree& tree);
+
+// Add the state reached by a delta of 'moves' moves as a child of the
+// current node, and make it current
+void undo_record(UndoTree& tree, const Delta& d, int moves);
+
+// Turn the state into the one at 'node' by reverting up to the common
+// ancestor and replaying down from it; false if node does not exist
+bool undo_jump(UndoTree& tree, const Level& level, State& state, int node);
+
+// Actions from the level start to the current node, in order
+std::string undo_path(const UndoTree& tree);
+
+void revert(const Level& level, State& state, const Delta& d);
+void replay(const Level& level, State& state, const Delta& d);
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Sokoban - Undo Tree Tests
+ *
+ * Builds a tree with two branches the way run_batch() records moves and
+ * checks that every jump between its nodes, as g-, g+, u and Ctrl-R make
+ * them, rebuilds exactly the state that was left there.
+ */
+
+#include "board.h"
+#include "undo_tree.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do                                                                \
+    {                                                                 \
+        if (!(cond))                                                  \
+        {                                                             \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+struct Game
+{
+    Level level;
+    State state;
+    UndoTree tree;
+    std::vector<State> seen; // The state left at each node, by node
+};
+
+static bool same(const State& a, const State& b)
+{
+    return a.blocks == b.blocks && a.px == b.px && a.py == b.py &&
+           a.holding_block == b.holding_block && a.unfilled_targets == b.unfilled_targets;
+}
+
+// Play actions as one history entry, like run_batch()
+static void play(Game& g, const std::string& actions)
+{
+    Delta d;
+    d.dx = 0;
+    d.dy = 0;
+    d.was_holding = g.state.holding_block;
+    int px = g.state.px, py = g.state.py;
+    for (char action : actions)
+    {
+        int cell = cell_index(g.level, g.state.px, g.state.py);
+        bool was_holding = g.state.holding_block;
+        bool moved = apply_action(g.level, g.state, action);
+        CHECK(moved);
+        if (g.state.holding_block != was_holding) d.flipped.push_back(cell);
+        d.actions += action;
+    }
+    d.dx = g.state.px - px;
+    d.dy = g.state.py - py;
+    undo_record(g.tree, d, actions.size());
+    g.seen.push_back(g.state);
+}
+
+static bool jump(Game& g, int node)
+{
+    return undo_jump(g.tree, g.level, g.state, node);
+}
+
+static void undo(Game& g)
+{
+    jump(g, g.tree.nodes[g.tree.current].parent);
+}
+
+static void redo(Game& g)
+{
+    jump(g, g.tree.nodes[g.tree.current].redo_child);
+}
+
+static void check_at(Game& g, int node)
+{
+    CHECK(g.tree.current == node);
+    CHECK(same(g.state, g.seen[node]));
+}
+
+// Two branches off node 1: 1-2-3-4 carries the first block to a target,
+// 1-5-6-7-8 the second to the other target
+static void build(Game& g)
+{
+    std::vector<std::string> rows = {
+        "#######",
+        "#.B...#",
+        "#..B..#",
+        "#.T.T.#",
+        "#######",
+    };
+    build_level(rows, 1, 1, g.level, g.state);
+    undo_reset(g.tree);
+    g.seen.assign(1, g.state);
+
+    play(g, "l");
+    play(g, "x");
+    play(g, "jj");
+    play(g, "p");
+    undo(g);
+    undo(g);
+    undo(g);
+    check_at(g, 1);
+
+    play(g, "jl");
+    play(g, "x");
+    play(g, "jl");
+    play(g, "p");
+    check_at(g, 8);
+}
+
+// g- and g+ walk the nodes in the order they were made, across branches
+static void test_walk_across_branches()
+{
+    Game g;
+    build(g);
+    for (int node = 7; node >= 0; --node)
+    {
+        CHECK(jump(g, g.tree.current - 1));
+        check_at(g, node);
+    }
+    CHECK(!jump(g, g.tree.current - 1));
+    for (int node = 1; node <= 8; ++node)
+    {
+        CHECK(jump(g, g.tree.current + 1));
+        check_at(g, node);
+    }
+    CHECK(!jump(g, g.tree.current + 1));
+
+    // Every node from every other, through their common ancestor
+    for (int from = 0; from <= 8; ++from)
+    {
+        for (int to = 0; to <= 8; ++to)
+        {
+            jump(g, from);
+            jump(g, to);
+            check_at(g, to);
+        }
+    }
+}
+
+// Ctrl-R after an undo takes the child made or visited last
+static void test_redo_picks_latest_child()
+{
+    Game g;
+    build(g);
+    jump(g, 1);
+    redo(g);
+    check_at(g, 5); // Made last
+
+    jump(g, 3);
+    undo(g);
+    undo(g);
+    check_at(g, 1);
+    redo(g);
+    check_at(g, 2); // Visited last
+    redo(g);
+    redo(g);
+    check_at(g, 4);
+    redo(g);
+    check_at(g, 4); // A leaf has nothing to redo
+}
+
+int main()
+{
+    test_walk_across_branches();
+    test_redo_picks_latest_child();
+
+    if (failures > 0)
+    {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All undo tree tests passed\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Sokoban - Solution Verifier
+ *
+ * Replays solution lines ('<level name> <moves> <actions>', as the game
+ * saves them) against their maps without a screen and checks each one
+ * solves its level in exactly the moves it claims. Prints every rejected
+ * line and exits non-zero if there was one.
+ *
+ * Usage: verify [-m maps_dir] [solutions_file | -]
+ */
+
+#include "board.h"
+#include "globals.h"
+#include "solution.h"
+#include "common/levelpack.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+struct Puzzle
+{
+    bool valid;
+    Level level;
+    State start;
+};
+
+// Levels by name, each built the first time a solution names it
+class Puzzles
+{
+public:
+    bool load(const std::string& dir)
+    {
+        if (!pack.load(dir)) return false;
+        for (int i = 0; i < pack.count(); ++i)
+        {
+            index[pack.name(i)] = i;
+        }
+        return true;
+    }
+
+    const Puzzle* find(const std::string& name)
+    {
+        auto built = puzzles.find(name);
+        if (built != puzzles.end()) return built->second.valid ? &built->second : nullptr;
+
+        Puzzle& p = puzzles[name];
+        p.valid = false;
+        auto it = index.find(name);
+        if (it == index.end()) return nullptr;
+
+        std::istringstream in(pack.text(it->second));
+        std::vector<std::string> rows;
+        int start_x = 1, start_y = 1;
+        read_map(in, rows, start_x, start_y);
+        if (rows.empty()) return nullptr;
+
+        build_level(rows, start_x, start_y, p.level, p.start);
+        p.valid = true;
+        return &p;
+    }
+
+private:
+    LevelPack pack;
+    std::unordered_map<std::string, int> index;
+    std::unordered_map<std::string, Puzzle> puzzles;
+};
+
+int main(int argc, char** argv)
+{
+    std::string dir = MAPS_LOCATION;
+    std::string file = solution_file();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) dir = argv[++i];
+        else file = argv[i];
+    }
+
+    Puzzles puzzles;
+    if (!puzzles.load(dir))
+    {
+        fprintf(stderr, "No maps found in %s\n", dir.c_str());
+        return 1;
+    }
+
+    std::ifstream in_file;
+    if (file != "-")
+    {
+        in_file.open(file.c_str());
+        if (!in_file.is_open())
+        {
+            fprintf(stderr, "Cannot read %s\n", file.c_str());
+            return 1;
+        }
+    }
+    std::istream& in = file == "-" ? std::cin : in_file;
+
+    long checked = 0, rejected = 0, line_no = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::string line;
+    while (std::getline(in, line))
+    {
+        line_no++;
+        std::string name, actions;
+        int moves;
+        if (line.empty() || line[0] == '#') continue;
+
+        const char* error = nullptr;
+        const Puzzle* p = nullptr;
+        if (!parse_solution(line, name, moves, actions)) error = "malformed line";
+        else if (!(p = puzzles.find(name))) error = "unknown level";
+        else if (moves != (int)actions.size()) error = "move count does not match the actions";
+        else if (!replay_solution(p->level, p->start, actions)) error = "does not solve the level";
+
+        checked++;
+        if (error)
+        {
+            rejected++;
+            printf("%s:%ld: %s: %s\n", file.c_str(), line_no, name.c_str(), error);
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+    printf("%ld solutions, %ld rejected, %.2f ms\n", checked, rejected, ms);
+    return rejected ? 1 : 0;
+}